@@ -156,9 +156,7 @@ void Framework::Agent::ForceSetPosition(const glm::vec2 position)
 
 	btRigidBody* rb = dynamic_cast<btRigidBody*>(GetCollisionObject());
 	assert(rb != nullptr);
-	rb->activate();
-	rb->setMotionState(&myTransform);
-	rb->activate();
+	mScene.mPhysics->MarkTransformChanged(*rb);
 }
 
 bool Framework::Agent::Serialize(Framework::Data::Scope& parentScope) const
@@ -263,9 +261,9 @@ glm::vec2 Framework::Agent::CalculateArrival(const glm::vec2 arriveAt) const
 	return (targetOffset / distToTarget) * scalar;
 }
 
-glm::vec2 Framework::Agent::CalculateWander() const
+glm::vec2 Framework::Agent::CalculateWander()
 {
-	const glm::vec2 wanderOffset = sFixedStepSize * glm::vec2{ Random::Range(-sWanderChangeSensitivity, sWanderChangeSensitivity), Random::Range(-sWanderChangeSensitivity, sWanderChangeSensitivity) };
+	const glm::vec2 wanderOffset = sFixedStepSize * glm::vec2{ Random::Range(-sWanderChangeSensitivity, sWanderChangeSensitivity, mRandomSeed), Random::Range(-sWanderChangeSensitivity, sWanderChangeSensitivity, mRandomSeed) };
 	return glm::normalize(glm::vec2{ mVelocity.x, mVelocity.z } + wanderOffset);
 }
 
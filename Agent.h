@@ -20,6 +20,7 @@ namespace Framework
 
         bool Serialize(Framework::Data::Scope& parentScope) const;
         void Deserialize(const Framework::Data::Scope& parentScope);
+        inline bool HasStateBesidesTransform() const { return true; }
 
         bool IsInRagdollState() const;
 
@@ -35,7 +36,7 @@ namespace Framework
         glm::vec2 CalculateAvoidance();
         glm::vec2 CalculateSeek(const glm::vec2 towardPosition) const;
         glm::vec2 CalculateArrival(const glm::vec2 arriveAt) const;
-        glm::vec2 CalculateWander() const;
+        glm::vec2 CalculateWander();
 
         // The recessive velocity will only be expressed when the dominant velocity has a length smaller than 1.0f.
         // The returned velocity is guarenteed to be no longer than 1.0f;
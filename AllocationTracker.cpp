@@ -0,0 +1,159 @@
+#include "precomp.h"
+#include "AllocationTracker.h"
+
+#include <new>
+#include <cstdlib>
+
+thread_local Framework::AllocationTracker::Counters Framework::AllocationTracker::sOnThisThread{};
+Framework::AllocationTracker::Counters Framework::AllocationTracker::sAtFrameStart{};
+Framework::AllocationTracker::Counters Framework::AllocationTracker::sLastFrame{};
+
+Framework::AllocationTracker::Counters Framework::AllocationTracker::GetTotal()
+{
+	return { sNumOfAllocations.load(std::memory_order_relaxed), sNumOfBytesAllocated.load(std::memory_order_relaxed), sNumOfFrees.load(std::memory_order_relaxed) };
+}
+
+Framework::AllocationTracker::Counters Framework::AllocationTracker::GetOnThisThread()
+{
+	return sOnThisThread;
+}
+
+void Framework::AllocationTracker::BeginFrame()
+{
+	const Counters total = GetTotal();
+	sLastFrame = total - sAtFrameStart;
+	sAtFrameStart = total;
+}
+
+Framework::AllocationTracker::Counters Framework::AllocationTracker::GetLastFrame()
+{
+	return sLastFrame;
+}
+
+void Framework::AllocationTracker::OnAllocation(const size_t size)
+{
+	sNumOfAllocations.fetch_add(1, std::memory_order_relaxed);
+	sNumOfBytesAllocated.fetch_add(size, std::memory_order_relaxed);
+
+	++sOnThisThread.mNumOfAllocations;
+	sOnThisThread.mNumOfBytesAllocated += size;
+}
+
+void Framework::AllocationTracker::OnFree()
+{
+	sNumOfFrees.fetch_add(1, std::memory_order_relaxed);
+	++sOnThisThread.mNumOfFrees;
+}
+
+#ifdef TRACK_ALLOCATIONS
+
+// Every form of operator new and delete is replaced, so that what the standard library allocates is always released by the matching function.
+
+static void* Allocate(const size_t size)
+{
+	Framework::AllocationTracker::OnAllocation(size);
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+static void* AllocateAligned(const size_t size, const std::align_val_t alignment)
+{
+	Framework::AllocationTracker::OnAllocation(size);
+
+	const size_t alignmentInBytes = static_cast<size_t>(alignment);
+#ifdef _MSC_VER
+	return _aligned_malloc(size == 0 ? 1 : size, alignmentInBytes);
+#else
+	// The size has to be a multiple of the alignment.
+	return std::aligned_alloc(alignmentInBytes, (std::max<size_t>(size, 1) + alignmentInBytes - 1) / alignmentInBytes * alignmentInBytes);
+#endif // _MSC_VER
+}
+
+static void Free(void* ptr)
+{
+	if (ptr != nullptr)
+	{
+		Framework::AllocationTracker::OnFree();
+		std::free(ptr);
+	}
+}
+
+static void FreeAligned(void* ptr)
+{
+	if (ptr != nullptr)
+	{
+		Framework::AllocationTracker::OnFree();
+#ifdef _MSC_VER
+		_aligned_free(ptr);
+#else
+		std::free(ptr);
+#endif // _MSC_VER
+	}
+}
+
+void* operator new(const size_t size)
+{
+	void* ptr = Allocate(size);
+
+	if (ptr == nullptr)
+	{
+		throw std::bad_alloc{};
+	}
+	return ptr;
+}
+
+void* operator new[](const size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(const size_t size, const std::nothrow_t&) noexcept
+{
+	return Allocate(size);
+}
+
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept
+{
+	return Allocate(size);
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment)
+{
+	void* ptr = AllocateAligned(size, alignment);
+
+	if (ptr == nullptr)
+	{
+		throw std::bad_alloc{};
+	}
+	return ptr;
+}
+
+void* operator new[](const size_t size, const std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return AllocateAligned(size, alignment);
+}
+
+void* operator new[](const size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return AllocateAligned(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept { Free(ptr); }
+void operator delete[](void* ptr) noexcept { Free(ptr); }
+void operator delete(void* ptr, const size_t) noexcept { Free(ptr); }
+void operator delete[](void* ptr, const size_t) noexcept { Free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { Free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { Free(ptr); }
+
+void operator delete(void* ptr, const std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete[](void* ptr, const std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete(void* ptr, const size_t, const std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete[](void* ptr, const size_t, const std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete(void* ptr, const std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(ptr); }
+void operator delete[](void* ptr, const std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(ptr); }
+
+#endif // TRACK_ALLOCATIONS
\ No newline at end of file
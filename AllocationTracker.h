@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+
+// Replaces the global operator new and delete while defined, every allocation then costs a few extra increments.
+#ifdef DEBUG
+#define TRACK_ALLOCATIONS
+#endif // DEBUG
+
+namespace Framework
+{
+	// Counts the heap allocations made through operator new, in total and for each thread. Only the number of frees is known, not
+	// how many bytes they released, since the size is not passed to every operator delete.
+	class AllocationTracker
+	{
+	public:
+		struct Counters
+		{
+			uint64_t mNumOfAllocations{};
+			uint64_t mNumOfBytesAllocated{};
+			uint64_t mNumOfFrees{};
+
+			inline Counters operator-(const Counters& other) const
+			{
+				return { mNumOfAllocations - other.mNumOfAllocations, mNumOfBytesAllocated - other.mNumOfBytesAllocated, mNumOfFrees - other.mNumOfFrees };
+			}
+
+			inline Counters& operator+=(const Counters& other)
+			{
+				mNumOfAllocations += other.mNumOfAllocations;
+				mNumOfBytesAllocated += other.mNumOfBytesAllocated;
+				mNumOfFrees += other.mNumOfFrees;
+				return *this;
+			}
+		};
+
+		static constexpr bool IsEnabled()
+		{
+#ifdef TRACK_ALLOCATIONS
+			return true;
+#else
+			return false;
+#endif // TRACK_ALLOCATIONS
+		}
+
+		// Everything allocated on all threads since the game started.
+		static Counters GetTotal();
+		// Only what the calling thread allocated, for measuring a scope without the other threads getting in the way.
+		static Counters GetOnThisThread();
+
+		// Called by the game at the start of every frame.
+		static void BeginFrame();
+		static Counters GetLastFrame();
+
+		static void OnAllocation(const size_t size);
+		static void OnFree();
+
+	private:
+		static inline std::atomic<uint64_t> sNumOfAllocations{};
+		static inline std::atomic<uint64_t> sNumOfBytesAllocated{};
+		static inline std::atomic<uint64_t> sNumOfFrees{};
+
+		static thread_local Counters sOnThisThread;
+
+		static Counters sAtFrameStart;
+		static Counters sLastFrame;
+	};
+}
\ No newline at end of file
@@ -62,7 +62,7 @@ void RTS::Army::SpawnUnits(const Framework::Data::Scope& loadFrom)
 		glm::vec2 centre;
 		group.GetVariable("centre") >> centre;
 
-		std::vector<glm::vec2> formation = GenerateFormation(units, { centre });
+		const Framework::FrameVector<glm::vec2> formation = GenerateFormation(units, { centre });
 
 		for (uint i = 0; i < amount; i++)
 		{
@@ -37,6 +37,7 @@ namespace RTS
 
 		bool Serialize(Framework::Data::Scope& parentScope) const override;
 		void Deserialize(const Framework::Data::Scope& parentScope) override;
+		inline bool HasStateBesidesTransform() const override { return true; }
 
 		size_t Size();
 		inline size_t NumOfUnitsSpawned() const { return mNumOfUnitsSpawned; }
@@ -12,6 +12,8 @@
 #include "Physics.h"
 #include "SavedData.h"
 #include "Scope.h"
+#include "Profiler.h"
+#include "FrameArena.h"
 
 #include "ImguiHelpers.h"
 #include "InputManager.h"
@@ -56,6 +58,8 @@ Framework::Camera::~Camera()
 
 void Framework::Camera::DrawScene()
 {
+	PROFILE_ZONE("Camera::DrawScene");
+
 	static bool drawWireFrame = false;
 	static bool drawMeshes = true;
 	static bool drawBounds = false;
@@ -77,6 +81,36 @@ void Framework::Camera::DrawScene()
 		ImGui::Checkbox("Draw bounds", &drawBounds);
 		ImGui::Checkbox("Update frustum", &updateFrustum);
 
+		bool showProfiler = Profiler::Inst().IsWindowOpen();
+		if (ImGui::Checkbox("Show profiler", &showProfiler))
+		{
+			Profiler::Inst().SetWindowOpen(showProfiler);
+		}
+
+		bool showTickCosts = TickCostTracker::IsWindowOpen();
+		if (ImGui::Checkbox("Show tick costs", &showTickCosts))
+		{
+			TickCostTracker::SetWindowOpen(showTickCosts);
+
+			// There is nothing to show unless the costs are being tracked.
+			if (showTickCosts)
+			{
+				mScene.mEntityManager->GetTickCosts().SetEnabled(true);
+			}
+		}
+
+		// Compare the Physics::Tick zone in the profiler between the two modes.
+		ImGui::Text("Physics: %s", mScene.mPhysics->IsMultithreaded() ? "multithreaded" : "single-threaded");
+
+		ImGui::Text("Frame arena: %.1f KB of %.1f KB", static_cast<float>(FrameArena::Inst().GetNumOfBytesUsed()) / 1024.0f, static_cast<float>(FrameArena::Inst().GetCapacity()) / 1024.0f);
+
+		if (AllocationTracker::IsEnabled())
+		{
+			const AllocationTracker::Counters allocations = AllocationTracker::GetLastFrame();
+			ImGui::Text("Allocations last frame: %llu (%.1f KB)", static_cast<unsigned long long>(allocations.mNumOfAllocations), static_cast<float>(allocations.mNumOfBytesAllocated) / 1024.0f);
+			ImGui::Text("Frees last frame: %llu", static_cast<unsigned long long>(allocations.mNumOfFrees));
+		}
+
 		if (ImGui::Button("Kill switch"))
 		{
 			mScene.mGame.Quit();
@@ -133,6 +167,9 @@ void Framework::Camera::DrawScene()
 		{
 			mScene.mEntityManager->DrawEntities();
 		}
+
+		// Chunks without a mesh have requested their patch to be drawn.
+		mScene.mTerrain->DrawRequestedPatches(*this);
 	}
 
 	if (drawBounds)
@@ -155,6 +192,11 @@ void Framework::Camera::DrawScene()
 
 		std::string output = "DeltaTime = " + std::to_string(avgDeltaTime);
 		ImGui::Text(output.c_str());
+
+		if (mScene.IsDeterministic())
+		{
+			ImGui::Text("Step %u, state hash = %016llx", mScene.GetNumOfStepsTaken(), static_cast<unsigned long long>(mScene.GetStateHash()));
+		}
 		ImGui::End();
 	}
 }
@@ -294,6 +336,8 @@ float Framework::Camera::CalculateFOV() const
 
 void Framework::Camera::ExecuteInstancingRequests()
 {
+	PROFILE_ZONE("Camera::ExecuteInstancingRequests");
+
 	uint totalAmountOfObjectsDrawn = 0;
 	uint amountOfRenderCallsMade = 0;
 
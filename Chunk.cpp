@@ -3,6 +3,7 @@
 
 #include "AssetManager.h"
 #include "Terrain.h"
+#include "TerrainData.h"
 #include "Mesh.h"
 #include "MyShader.h"
 #include "Material.h"
@@ -12,14 +13,52 @@
 #include "Physics.h"
 #include "Scope.h"
 
-Framework::Chunk::Chunk(Scene& scene, const glm::vec2 position) : 
+static std::vector<Framework::Mesh::Triangle> GenerateTriangles()
+{
+	using Framework::Chunk;
+
+	std::vector<Framework::Mesh::Triangle> triangles((Chunk::sNumOfVerticesX - 1) * (Chunk::sNumOfVerticesZ - 1) * 2);
+
+	for (ushort z = 0, triangleIndex = 0; z < Chunk::sNumOfVerticesZ - 1; z++)
+	{
+		for (ushort x = 0; x < Chunk::sNumOfVerticesX - 1; x++, triangleIndex += 2)
+		{
+			// Weird work around to surpress a compiler warning.
+			const ushort vertexIndex = static_cast<ushort>(static_cast<int>(x) + static_cast<int>(z) * static_cast<int>(Chunk::sNumOfVerticesX));
+
+			triangles[triangleIndex] = { vertexIndex, static_cast<ushort>(vertexIndex + 1 + Chunk::sNumOfVerticesX), static_cast<ushort>(vertexIndex + 1) };
+			triangles[triangleIndex + 1] = { vertexIndex, static_cast<ushort>(vertexIndex + Chunk::sNumOfVerticesX),  static_cast<ushort>(vertexIndex + 1 + Chunk::sNumOfVerticesX) };
+		}
+	}
+
+	return triangles;
+}
+
+Framework::Chunk::Chunk(Scene& scene, const glm::vec2 position, const std::optional<MeshData>& generatedMesh) : 
 	Entity(scene)
 {
 	Transform& transform = GetTransform();
 	transform.SetLocalPosition(position.x, scene.mTerrain->GetData()->GetHeighestVertexHeight() * .5f, position.y);
 	mModelMatrix = transform.GetLocalMatrix();
 
-	GenerateMesh(transform.GetLocalPosition(), *scene.mTerrain);
+	// No need to generate a mesh if the terrain will be drawn using the heightmap.
+	if (!scene.mTerrain->IsRenderedFromHeightMap())
+	{
+		if (generatedMesh.has_value())
+		{
+			UploadMesh(generatedMesh.value());
+		}
+		else
+		{
+			std::vector<glm::vec3> vertices(sNumOfVertices);
+			std::vector<glm::vec3> normals(sNumOfVertices);
+			std::vector<glm::vec2> UVs(sNumOfVertices);
+
+			const MeshData meshData = { &vertices[0], &normals[0], &UVs[0] };
+			GenerateMeshData(position, *scene.mTerrain->GetData(), meshData);
+			UploadMesh(meshData);
+		}
+	}
 
 	mCollisionObject = std::make_unique<btCollisionObject>();
 
@@ -38,6 +77,13 @@ Framework::Chunk::~Chunk()
 
 void Framework::Chunk::Draw() const
 {
+	if (mMesh == nullptr)
+	{
+		const glm::vec3 position = GetTransform().GetLocalPosition();
+		mScene.mTerrain->RequestPatchDraw({ position.x, position.z });
+		return;
+	}
+
 	const MyShader* shader = mMesh->GetShader();
 	shader->Bind();
 
@@ -51,63 +97,82 @@ void Framework::Chunk::Draw() const
 	shader->Unbind();
 }
 
-void Framework::Chunk::GenerateMesh(const glm::vec3 position, const Terrain& terrain)
+void Framework::Chunk::GenerateMeshData(const glm::vec2 position, const TerrainData& terrainData, const MeshData& out)
 {
 	static_assert(static_cast<unsigned long>(sNumOfVerticesX) * static_cast<unsigned long>(sNumOfVerticesZ) < std::numeric_limits<ushort>::max());
 
-	const ushort numOfVertices = sNumOfVerticesX * sNumOfVerticesZ;
-
-	std::vector<glm::vec3> vertices(numOfVertices);
-	std::vector<glm::vec3> normals(numOfVertices);
-
-	std::vector<glm::vec2> UVs(numOfVertices);
+	// The same height the chunk's transform is placed at.
+	const float positionY = terrainData.GetHeighestVertexHeight() * .5f;
 
-	const TerrainData* const terrainData = terrain.GetData();
-
-	const glm::vec2 chunkCorner = glm::vec2{ position.x, position.z } - glm::vec2{ sSizeX, sSizeZ } * 0.5f;
-	const glm::ivec2 sampleStart = terrainData->WorldToSample(chunkCorner.x, chunkCorner.y);
-	uint sampleIndex = sampleStart.x + sampleStart.y * terrainData->mNumOfVerticesX;
+	const glm::vec2 chunkCorner = position - glm::vec2{ sSizeX, sSizeZ } * 0.5f;
+	const glm::ivec2 sampleStart = terrainData.WorldToSample(chunkCorner.x, chunkCorner.y);
+	uint sampleIndex = sampleStart.x + sampleStart.y * terrainData.mNumOfVerticesX;
 
 	// Generate vertices
-	for (ushort z = 0; z < sNumOfVerticesZ; z++, sampleIndex += terrainData->mNumOfVerticesX)
+	for (ushort z = 0; z < sNumOfVerticesZ; z++, sampleIndex += terrainData.mNumOfVerticesX)
 	{
 		for (ushort x = 0; x < sNumOfVerticesX; x++)
 		{
 			// Weird work around to surpress a compiler warning.
 			const ushort vertexIndex = static_cast<ushort>(static_cast<int>(x) + static_cast<int>(z) * static_cast<int>(sNumOfVerticesX));
 			
-			glm::vec3& localVertexPosition = vertices[vertexIndex];
-			localVertexPosition = { static_cast<float>(x) * sSpaceBetweenVertices - sSizeX * 0.5f, terrainData->GetHeightAtIndex(sampleIndex + x) - position.y, static_cast<float>(z) * sSpaceBetweenVertices - sSizeZ * 0.5f};
+			glm::vec3& localVertexPosition = out.mVertices[vertexIndex];
+			localVertexPosition = { static_cast<float>(x) * sSpaceBetweenVertices - sSizeX * 0.5f, terrainData.GetHeightAtIndex(sampleIndex + x) - positionY, static_cast<float>(z) * sSpaceBetweenVertices - sSizeZ * 0.5f};
 
-			UVs[vertexIndex] = { (localVertexPosition.x * sTextureResolution) / sSizeX, (localVertexPosition.z * sTextureResolution) / sSizeZ};
-			normals[vertexIndex] = terrainData->GetNormalAtPosition(sampleIndex + x);
+			out.mUVs[vertexIndex] = { (localVertexPosition.x * sTextureResolution) / sSizeX, (localVertexPosition.z * sTextureResolution) / sSizeZ};
+			out.mNormals[vertexIndex] = terrainData.GetNormalAtPosition(sampleIndex + x);
 		}
 	}
+}
+
+void Framework::Chunk::UploadMesh(const MeshData& meshData)
+{
+	// Every chunk is triangulated the same way.
+	static const std::vector<Mesh::Triangle> sTriangles = GenerateTriangles();
+
+	mMesh = std::make_unique<Mesh>();
+
+	mMesh->SetTriangles(sTriangles);
+	mMesh->UploadVertices(meshData.mVertices, sNumOfVertices);
+	mMesh->UploadNormals(meshData.mNormals, sNumOfVertices);
+	mMesh->UploadUVs(meshData.mUVs, sNumOfVertices);
+
+	AssetManager& assetManager = AssetManager::Inst();
+	
+	mMesh->SetShader(assetManager.GetAsset<MyShader>("shaders/terrain.vert,shaders/terrain.frag"));
+	mMesh->SetMaterial(assetManager.GetAsset<Material>("materials/terrain.mtl"));
+}
 
-	// Generate triangles
-	std::vector<Mesh::Triangle> triangles((sNumOfVerticesX - 1) * (sNumOfVerticesZ - 1) * 2);
+std::unique_ptr<Framework::Mesh> Framework::Chunk::GeneratePatchMesh()
+{
+	std::vector<glm::vec3> vertices(sNumOfVertices);
+	std::vector<glm::vec2> UVs(sNumOfVertices);
 
-	for (ushort z = 0, triangleIndex = 0; z < sNumOfVerticesZ - 1; z++)
+	// The height is sampled from the heightmap in the vertex shader, the UVs are the same as for a regular chunk.
+	for (ushort z = 0; z < sNumOfVerticesZ; z++)
 	{
-		for (ushort x = 0; x < sNumOfVerticesX - 1; x++, triangleIndex += 2)
+		for (ushort x = 0; x < sNumOfVerticesX; x++)
 		{
 			// Weird work around to surpress a compiler warning.
 			const ushort vertexIndex = static_cast<ushort>(static_cast<int>(x) + static_cast<int>(z) * static_cast<int>(sNumOfVerticesX));
 
-			triangles[triangleIndex] = { vertexIndex, static_cast<ushort>(vertexIndex + 1 + sNumOfVerticesX), static_cast<ushort>(vertexIndex + 1) };
-			triangles[triangleIndex + 1] = { vertexIndex, static_cast<ushort>(vertexIndex + sNumOfVerticesX),  static_cast<ushort>(vertexIndex + 1 + sNumOfVerticesX) };
+			glm::vec3& localVertexPosition = vertices[vertexIndex];
+			localVertexPosition = { static_cast<float>(x) * sSpaceBetweenVertices - sSizeX * 0.5f, 0.0f, static_cast<float>(z) * sSpaceBetweenVertices - sSizeZ * 0.5f };
+
+			UVs[vertexIndex] = { (localVertexPosition.x * sTextureResolution) / sSizeX, (localVertexPosition.z * sTextureResolution) / sSizeZ };
 		}
 	}
 
-	mMesh = std::make_unique<Mesh>();
+	std::unique_ptr<Mesh> mesh = std::make_unique<Mesh>();
 
-	mMesh->SetTriangles(std::move(triangles));
-	mMesh->SetVertices(std::move(vertices));
-	mMesh->SetNormals(std::move(normals));
-	mMesh->SetUVs(std::move(UVs));
+	mesh->SetTriangles(GenerateTriangles());
+	mesh->SetVertices(std::move(vertices));
+	mesh->SetUVs(std::move(UVs));
 
 	AssetManager& assetManager = AssetManager::Inst();
-	
-	mMesh->SetShader(assetManager.GetAsset<MyShader>("shaders/terrain.vert,shaders/terrain.frag"));
-	mMesh->SetMaterial(assetManager.GetAsset<Material>("materials/terrain.mtl"));
+
+	mesh->SetShader(assetManager.GetAsset<MyShader>("shaders/terrain.vert,shaders/terrain.frag"));
+	mesh->SetMaterial(assetManager.GetAsset<Material>("materials/terrain.mtl"));
+
+	return mesh;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 namespace Framework
 {
 	class Terrain;
+	class TerrainData;
 	class Mesh;
 	class Camera;
 
@@ -12,7 +13,17 @@ namespace Framework
 	{
 		ENTITYMAKER(Chunk);
 	public:
-		Chunk(Scene& scene, const glm::vec2 position = {0.0f, 0.0f});
+		// Where the CPU side of a chunk's mesh is written to. It points to memory owned by someone else, 
+		// so the meshes of many chunks can be generated into a single arena.
+		struct MeshData
+		{
+			glm::vec3* mVertices{};
+			glm::vec3* mNormals{};
+			glm::vec2* mUVs{};
+		};
+
+		// If the mesh has not been generated in advance, the chunk will generate it itself.
+		Chunk(Scene& scene, const glm::vec2 position = {0.0f, 0.0f}, const std::optional<MeshData>& generatedMesh = {});
 		~Chunk();
 
 		void Draw() const override;
@@ -30,8 +41,17 @@ namespace Framework
 
 		static constexpr ushort sNumOfVerticesX = static_cast<ushort>(static_cast<float>(sSizeX) / sSpaceBetweenVertices) + 1;
 		static constexpr ushort sNumOfVerticesZ = static_cast<ushort>(static_cast<float>(sSizeZ) / sSpaceBetweenVertices) + 1;
+		static constexpr ushort sNumOfVertices = sNumOfVerticesX * sNumOfVerticesZ;
+
+		// Only reads from the terrain data, so it's safe to call from multiple threads at once.
+		static void GenerateMeshData(const glm::vec2 position, const TerrainData& terrainData, const MeshData& out);
+
+		// A flat grid the size of a single chunk, centred around the origin. Used when the terrain is displaced
+		// using the heightmap in the vertex shader, so one mesh can be shared by all chunks.
+		static std::unique_ptr<Mesh> GeneratePatchMesh();
+
 	private:
-		void GenerateMesh(const glm::vec3 position, const Terrain& terrain);
+		void UploadMesh(const MeshData& meshData);
 
 		glm::mat4 mModelMatrix{};
 		std::unique_ptr<Mesh> mMesh{};
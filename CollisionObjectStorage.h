@@ -0,0 +1,50 @@
+#pragma once
+
+namespace Framework
+{
+	// Always destroys the collision object, but only frees it if it was allocated on its own instead of inside a CollisionObjectStorage.
+	struct CollisionObjectDeleter
+	{
+		CollisionObjectDeleter() = default;
+		CollisionObjectDeleter(const bool isInStorage) : mIsInStorage(isInStorage) {}
+
+		// So that collision objects made with std::make_unique can still be assigned.
+		template<typename T>
+		CollisionObjectDeleter(const std::default_delete<T>&) {}
+
+		inline void operator()(btCollisionObject* object) const
+		{
+			if (mIsInStorage)
+			{
+				object->~btCollisionObject();
+			}
+			else
+			{
+				delete object;
+			}
+		}
+
+		bool mIsInStorage{};
+	};
+
+	using CollisionObjectPtr = std::unique_ptr<btCollisionObject, CollisionObjectDeleter>;
+
+	// Room for a collision object inside the entity that owns it, so that both are allocated at once and end up next to each other.
+	// The entity has to destroy the collision object before its own destructor returns, which it already does by removing it from the world.
+	template<typename T>
+	class CollisionObjectStorage
+	{
+	public:
+		static_assert(std::is_base_of_v<btCollisionObject, T>);
+
+		// Only one object can be in the storage at a time, the previous one has to be destroyed first.
+		template<typename ...Args>
+		inline CollisionObjectPtr Construct(Args&& ...args)
+		{
+			return CollisionObjectPtr(new (mStorage) T(std::forward<Args>(args)...), CollisionObjectDeleter{ true });
+		}
+
+	private:
+		alignas(T) std::byte mStorage[sizeof(T)];
+	};
+}
\ No newline at end of file
@@ -22,7 +22,13 @@ namespace RTS
 	void FormUniformFormation(std::vector<Unit*> units, const glm::vec2 position, const std::optional<float> rotation);
 }
 
-std::vector<glm::vec2> RTS::GenerateFormation(const std::vector<Unit*>& units, const glm::vec2 position)
+static RTS::Replay* TryGetRecordingReplay(const std::vector<RTS::Unit*>& units)
+{
+	RTS::Replay* replay = RTS::Replay::TryGet(units[0]->GetScene());
+	return replay != nullptr && replay->IsRecording() ? replay : nullptr;
+}
+
+Framework::FrameVector<glm::vec2> RTS::GenerateFormation(const std::vector<Unit*>& units, const glm::vec2 position)
 {
 	if (units.empty())
 	{
@@ -39,7 +45,7 @@ std::vector<glm::vec2> RTS::GenerateFormation(const std::vector<Unit*>& units, c
 	const float spacing = /*biggestUnit->GetRadius() **/ 10.0f;
 
 	// Generate points
-	std::vector<glm::vec2> points(units.size());
+	Framework::FrameVector<glm::vec2> points(units.size());
 	uint totalNumberOfPoints{};
 
 	float distFromCentre = 0.0f;
@@ -69,7 +75,7 @@ void RTS::FormFormation(std::vector<Unit*> units, const glm::vec2 position, cons
 // the vector of units passed in consists of either air or ground units, not a mix of both.
 void RTS::FormUniformFormation(std::vector<Unit*> units, const glm::vec2 position, const std::optional<float> rotation)
 {
-	const std::vector<glm::vec2> points = GenerateFormation(units, position);
+	const Framework::FrameVector<glm::vec2> points = GenerateFormation(units, position);
 	const glm::vec2 groupCentre = GetCentre(units);
 
 	const glm::vec2 deltaPosGroup = position - groupCentre;
@@ -96,6 +102,86 @@ void RTS::FormUniformFormation(std::vector<Unit*> units, const glm::vec2 positio
 	}
 }
 
+void RTS::OrderMoveTo(const OrderIssuer issuer, const std::vector<Unit*>& units, const glm::vec2 position, const std::optional<glm::vec2> desiredForward)
+{
+	if (units.empty())
+	{
+		return;
+	}
+
+	if (Replay* replay = TryGetRecordingReplay(units); replay != nullptr)
+	{
+		replay->RecordMoveTo(issuer, units, units[0]->GetScene().GetNumOfStepsTaken(), position, desiredForward);
+	}
+
+	for (Unit* unit : units)
+	{
+		unit->GiveCommand<CommandMoveTo>(position, desiredForward);
+	}
+}
+
+void RTS::OrderAttack(const OrderIssuer issuer, const std::vector<Unit*>& units, const Framework::EntityId target)
+{
+	if (units.empty())
+	{
+		return;
+	}
+
+	if (Replay* replay = TryGetRecordingReplay(units); replay != nullptr)
+	{
+		replay->RecordAttack(issuer, units, units[0]->GetScene().GetNumOfStepsTaken(), target);
+	}
+
+	for (Unit* unit : units)
+	{
+		unit->GiveCommand<CommandAttack>(target);
+	}
+}
+
+void RTS::OrderFormation(const OrderIssuer issuer, std::vector<Unit*> units, const glm::vec2 position, const std::optional<float> rotation)
+{
+	if (units.empty())
+	{
+		return;
+	}
+
+	if (Replay* replay = TryGetRecordingReplay(units); replay != nullptr)
+	{
+		replay->RecordFormation(issuer, units, units[0]->GetScene().GetNumOfStepsTaken(), position, rotation);
+	}
+
+	FormFormation(std::move(units), position, rotation);
+}
+
+void RTS::OrderAggroLevel(const OrderIssuer issuer, const std::vector<Unit*>& units, const AggroLevel aggroLevel)
+{
+	// The opponent keeps ordering the same aggro level, only the units it actually changes for are worth recording.
+	std::vector<Unit*> unitsToChange{};
+
+	for (Unit* unit : units)
+	{
+		if (unit->GetAggroLevel() != aggroLevel)
+		{
+			unitsToChange.push_back(unit);
+		}
+	}
+
+	if (unitsToChange.empty())
+	{
+		return;
+	}
+
+	if (Replay* replay = TryGetRecordingReplay(unitsToChange); replay != nullptr)
+	{
+		replay->RecordAggroLevel(issuer, unitsToChange, unitsToChange[0]->GetScene().GetNumOfStepsTaken(), aggroLevel);
+	}
+
+	for (Unit* unit : unitsToChange)
+	{
+		unit->SetAggroLevel(aggroLevel);
+	}
+}
+
 Framework::Agent::AgentInput RTS::CommandIdle::CalculateAgentInput(Unit* unit) const
 {
 	if (unit->GetAggroLevel() != AggroLevel::pursuit)
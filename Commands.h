@@ -1,5 +1,7 @@
 #pragma once
 #include "Agent.h"
+#include "Replay.h"
+#include "FrameArena.h"
 
 namespace RTS
 {
@@ -43,7 +45,14 @@ namespace RTS
 		Framework::EntityId mTarget{};
 	};
 
-	std::vector<glm::vec2> GenerateFormation(const std::vector<Unit*>& units, const glm::vec2 position);
+	// Allocated from the frame arena.
+	Framework::FrameVector<glm::vec2> GenerateFormation(const std::vector<Unit*>& units, const glm::vec2 position);
 
 	void FormFormation(std::vector<Unit*> units, const glm::vec2 position, const std::optional<float> rotation = {});
+
+	// Orders given by the player or the opponent, as opposed to the commands units give themselves. These are recorded if the level is recording a replay.
+	void OrderMoveTo(const OrderIssuer issuer, const std::vector<Unit*>& units, const glm::vec2 position, const std::optional<glm::vec2> desiredForward = {});
+	void OrderAttack(const OrderIssuer issuer, const std::vector<Unit*>& units, const Framework::EntityId target);
+	void OrderFormation(const OrderIssuer issuer, std::vector<Unit*> units, const glm::vec2 position, const std::optional<float> rotation = {});
+	void OrderAggroLevel(const OrderIssuer issuer, const std::vector<Unit*>& units, const AggroLevel aggroLevel);
 }
\ No newline at end of file
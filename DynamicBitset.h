@@ -1,5 +1,7 @@
 #pragma once
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <vector>
 #include <sstream>
 #include <string>
@@ -164,6 +166,15 @@ namespace DB
 					|| (mByteIndex == other.mByteIndex && mBitIndex < other.mBitIndex);
 			}
 
+			// Skips ahead by multiple bits at once.
+			DerivedType& operator+=(const size_t numOfBits)
+			{
+				const size_t bitPosition = static_cast<size_t>(mBitIndex) + numOfBits;
+				mByteIndex += bitPosition / sNumOfBitsInByte;
+				mBitIndex = static_cast<bit_index>(bitPosition % sNumOfBitsInByte);
+				return *static_cast<DerivedType*>(this);
+			}
+
 		protected:
 			byte_index mByteIndex{};
 			bit_index mBitIndex{};
@@ -324,13 +335,53 @@ namespace DB
 
 		inline void push_back(const char* dataStart, const size_t numOfBytes)
 		{
-			for (size_t i = 0; i < numOfBytes; i++)
+			if (numOfBytes == 0)
+			{
+				return;
+			}
+
+			const size_t oldSize = mData.size();
+
+			// When byte aligned, the bytes can be copied as they are.
+			if (!isThereAnIncompleteByte())
+			{
+				mData.resize(oldSize + numOfBytes);
+				memcpy(mData.data() + oldSize, dataStart, numOfBytes);
+				return;
+			}
+
+			// Otherwise every byte is split over two bytes; the incomplete byte keeps the bits that are left over at the end.
+			const unsigned int shift = mIncompleteByte.mNumOfBits;
+			const unsigned int carryShift = sNumOfBitsInByte - shift;
+			uint64_t carry = static_cast<unsigned char>(static_cast<char>(mIncompleteByte.mByte)) >> carryShift;
+
+			mData.resize(oldSize + numOfBytes);
+			unsigned char* destination = reinterpret_cast<unsigned char*>(mData.data() + oldSize);
+			const unsigned char* source = reinterpret_cast<const unsigned char*>(dataStart);
+
+			size_t i = 0;
+			for (; i + sizeof(uint64_t) <= numOfBytes; i += sizeof(uint64_t))
+			{
+				const uint64_t word = loadBigEndianWord(source + i);
+				storeBigEndianWord(destination + i, (carry << (64 - shift)) | (word >> shift));
+				carry = word & ((uint64_t{ 1 } << shift) - 1);
+			}
+
+			for (; i < numOfBytes; i++)
 			{
-				push_back(byte{ dataStart[i] });
+				destination[i] = static_cast<unsigned char>((carry << carryShift) | (source[i] >> shift));
+				carry = source[i] & ((1u << shift) - 1);
 			}
+
+			mIncompleteByte.mByte = static_cast<char>(carry << carryShift);
 		}
 
 		inline void push_back(const std::string& string)
+		{
+			push_back(std::string_view{ string });
+		}
+
+		inline void push_back(std::string_view string)
 		{
 			// We can't use the terminating character, since the string might represent binary data with coincidental terminating characters inside.
 			if (string.size() > std::numeric_limits<unsigned char>::max())
@@ -343,7 +394,35 @@ namespace DB
 				push_back(true);
 				push_back(static_cast<unsigned char>(string.size()));
 			}
-			push_back(string.c_str(), string.size());
+			push_back(string.data(), string.size());
+		}
+
+		// Appends the lowest numOfBits of the value, starting with the most significant of those bits.
+		// Fills up whole bytes at once, instead of going bit by bit.
+		inline void push_back_bits(const uint64_t value, unsigned int numOfBits)
+		{
+			assert(numOfBits <= 64);
+
+			while (numOfBits > 0)
+			{
+				const unsigned int numOfFreeBits = sNumOfBitsInByte - mIncompleteByte.mNumOfBits;
+				const unsigned int numOfBitsToAdd = numOfFreeBits < numOfBits ? numOfFreeBits : numOfBits;
+				const unsigned int mask = (1u << numOfBitsToAdd) - 1u;
+				const unsigned int bitsToAdd = static_cast<unsigned int>(value >> (numOfBits - numOfBitsToAdd)) & mask;
+				const unsigned int shift = numOfFreeBits - numOfBitsToAdd;
+
+				char& data = mIncompleteByte.mByte;
+				data = static_cast<char>((static_cast<unsigned char>(data) & ~(mask << shift)) | (bitsToAdd << shift));
+
+				mIncompleteByte.mNumOfBits = static_cast<bit_index>(mIncompleteByte.mNumOfBits + numOfBitsToAdd);
+				numOfBits -= numOfBitsToAdd;
+
+				if (mIncompleteByte.isFull())
+				{
+					mData.push_back(mIncompleteByte.mByte);
+					mIncompleteByte.mNumOfBits = 0;
+				}
+			}
 		}
 
 		inline void push_back(byte byte)
@@ -383,6 +462,12 @@ namespace DB
 			mData.pop_back();
 		}
 
+		// Allocates enough memory for the bitset to grow to the given size without reallocating.
+		inline void reserve(const size_t numOfBits)
+		{
+			mData.reserve((numOfBits + sNumOfBitsInByte - 1) / sNumOfBitsInByte);
+		}
+
 		inline void clear()
 		{
 			mData.clear();
@@ -432,6 +517,30 @@ namespace DB
 			return returnByte;
 		}
 
+		// Returns the next numOfBits (at most 57) bits starting at the iterator, without incrementing it. The first bit ends
+		// up as the most significant of the returned bits. Reading past the end is allowed, those bits are returned as 0.
+		template<typename IteratorType>
+		static inline uint64_t peek_bits(const IteratorType& it, const unsigned int numOfBits)
+		{
+			assert(numOfBits <= 57);
+
+			if (numOfBits == 0)
+			{
+				return 0;
+			}
+
+			const unsigned int numOfBytes = (it.mBitIndex + numOfBits + sNumOfBitsInByte - 1) / sNumOfBitsInByte;
+			uint64_t bits = 0;
+
+			for (unsigned int i = 0; i < numOfBytes; i++)
+			{
+				bits = (bits << sNumOfBitsInByte) | it.mSource->getByteForPeeking(it.mByteIndex + i);
+			}
+
+			bits >>= numOfBytes * sNumOfBitsInByte - it.mBitIndex - numOfBits;
+			return bits & ((uint64_t{ 1 } << numOfBits) - 1);
+		}
+
 		// Creates and returns an instance of the type by using the next sizeof(type) bytes.
 		template <typename TriviablyCopyableType>
 		inline TriviablyCopyableType extract(byte_index byteIndex, bit_index bitIndex) const
@@ -460,11 +569,57 @@ namespace DB
 		template<typename IteratorType>
 		static inline void extract(char* destination, size_t amountOfBytesToExtract, IteratorType& it)
 		{
-			for (size_t i = 0; i < amountOfBytesToExtract; i++)
+			const auto* const source = it.mSource;
+
+#if _ITERATOR_DEBUG_LEVEL > 0
+			assert((source->size_in_bits() - (it.mByteIndex * sNumOfBitsInByte + it.mBitIndex)) / sNumOfBitsInByte >= amountOfBytesToExtract);
+#endif // _ITERATOR_DEBUG_LEVEL
+
+			const size_t numOfCompleteBytes = it.mByteIndex < source->mData.size() ? source->mData.size() - it.mByteIndex : 0;
+			const unsigned char* const from = reinterpret_cast<const unsigned char*>(source->mData.data()) + it.mByteIndex;
+			unsigned char* const to = reinterpret_cast<unsigned char*>(destination);
+			size_t i = 0;
+
+			if (it.mBitIndex == 0)
 			{
-				// Use operator&, because conversion sequence is better.
-				destination[i] = static_cast<char&>(getByte(it));
+				// Byte aligned, so whatever is in the complete bytes can be copied as is.
+				i = amountOfBytesToExtract < numOfCompleteBytes ? amountOfBytesToExtract : numOfCompleteBytes;
+
+				if (i != 0)
+				{
+					memcpy(to, from, i);
+				}
 			}
+			else
+			{
+				// Each byte is made up of the end of one byte and the start of the next one.
+				const unsigned int shift = it.mBitIndex;
+
+				for (; i + sizeof(uint64_t) < numOfCompleteBytes && i + sizeof(uint64_t) <= amountOfBytesToExtract; i += sizeof(uint64_t))
+				{
+					const uint64_t word = loadBigEndianWord(from + i);
+					storeBigEndianWord(to + i, (word << shift) | (from[i + sizeof(uint64_t)] >> (sNumOfBitsInByte - shift)));
+				}
+			}
+
+			// The remainder might include the incomplete byte.
+			for (; i < amountOfBytesToExtract; i++)
+			{
+				const unsigned int bits = (source->getByteForPeeking(it.mByteIndex + i) << sNumOfBitsInByte) | source->getByteForPeeking(it.mByteIndex + i + 1);
+				to[i] = static_cast<unsigned char>(bits >> (sNumOfBitsInByte - it.mBitIndex));
+			}
+
+			it.mByteIndex += amountOfBytesToExtract;
+		}
+
+		// Reads how long the string that was pushed back is, the iterator is left at the start of its characters.
+		// Allows the characters to be extracted straight into wherever they need to end up.
+		template<typename IteratorType>
+		static inline size_t extract_string_size(IteratorType& it)
+		{
+			DB::bit sizeAsChar = it++;
+
+			return sizeAsChar ? static_cast<size_t>(extract<unsigned char>(it)) : extract<size_t>(it);
 		}
 
 		// Fills the destination with the bytes specified using the byteIndex and bitIndex
@@ -536,6 +691,42 @@ namespace DB
 		}
 
 	private:
+		static inline uint64_t loadBigEndianWord(const unsigned char* bytes)
+		{
+			uint64_t word = 0;
+			for (size_t i = 0; i < sizeof(uint64_t); i++)
+			{
+				word = (word << sNumOfBitsInByte) | bytes[i];
+			}
+			return word;
+		}
+
+		static inline void storeBigEndianWord(unsigned char* bytes, const uint64_t word)
+		{
+			for (size_t i = 0; i < sizeof(uint64_t); i++)
+			{
+				bytes[i] = static_cast<unsigned char>(word >> ((sizeof(uint64_t) - 1 - i) * sNumOfBitsInByte));
+			}
+		}
+
+		inline unsigned char getByteForPeeking(const byte_index byteIndex) const
+		{
+			if (byteIndex < mData.size())
+			{
+				return static_cast<unsigned char>(static_cast<char>(mData[byteIndex]));
+			}
+
+			if (byteIndex == mData.size()
+				&& isThereAnIncompleteByte())
+			{
+				// The bits that have not been pushed yet might still hold old values.
+				const unsigned int validBits = 0xFFu << (sNumOfBitsInByte - mIncompleteByte.mNumOfBits);
+				return static_cast<unsigned char>(static_cast<unsigned char>(static_cast<char>(mIncompleteByte.mByte)) & validBits);
+			}
+
+			return 0;
+		}
+
 		template<typename IteratorType, typename From>
 		static IteratorType begin(From* fromBitset)
 		{
@@ -567,13 +758,9 @@ namespace DB
 		template <typename IteratorType>
 		static inline void extract(IteratorType& it, std::string& out)
 		{
-			DB::bit sizeAsChar = it++;
-
-			const size_t numOfBytes = sizeAsChar ? static_cast<size_t>(extract<unsigned char>(it)) : extract<size_t>(it);
-			char* data = new char[numOfBytes];
-			extract(data, numOfBytes, it);
-			out = { data, numOfBytes };
-			delete[] data;
+			const size_t numOfBytes = extract_string_size(it);
+			out.resize(numOfBytes);
+			extract(out.data(), numOfBytes, it);
 		}
 
 		std::vector<byte> mData{};
@@ -13,8 +13,8 @@ Framework::Entity::Entity(Scene& scene) :
 	mScene(scene),
 	mTransform(this)
 {
-	mTimeSinceFixedTick = Random::Range(sFixedStepSize);
 	mId = mScene.mEntityManager->AllocId(this);
+	ResetRandomSeed();
 }
 
 Framework::Entity::~Entity()
@@ -24,7 +24,7 @@ Framework::Entity::~Entity()
 
 void Framework::Entity::Draw() const
 {
-	DrawOwnerAndChildren(mTransform, mTransform.GetLocalMatrix(), *mScene.mCamera);
+	DrawOwnerAndChildren(mTransform, *mScene.mCamera);
 }
 
 void Framework::Entity::AttemptFixedTick()
@@ -38,6 +38,20 @@ void Framework::Entity::AttemptFixedTick()
 	}
 }
 
+void Framework::Entity::ResetRandomSeed()
+{
+	mRandomSeed = static_cast<uint>(Math::Hash(static_cast<EntityId>(mId), Math::Hash(mScene.GetRandomSeed())));
+
+	// Xorshift gets stuck on 0.
+	if (mRandomSeed == 0)
+	{
+		mRandomSeed = 1;
+	}
+
+	// Spreads out the fixed ticks of entities created in the same frame.
+	mTimeSinceFixedTick = Random::Range(sFixedStepSize, mRandomSeed);
+}
+
 void DestroyTransformOwnerAndChildren(Framework::Transform& transform, Framework::EntityManager* entityManager)
 {
 	Framework::Entity* const transformOwner = transform.GetOwner();
@@ -80,41 +94,134 @@ bool Framework::Entity::Serialize(Data::Scope& parentScope) const
 
 void Framework::Entity::Deserialize(const Data::Scope& parentScope)
 {
-	const Data::Scope& myScope = parentScope.GetScope("Entity");
+	// When loading a save, the states of all entities have already been decoded on every core.
+	std::optional<SavedState> state = mScene.mEntityManager->TakeDecodedState();
+	if (!state.has_value())
+	{
+		state = DecodeSavedState(parentScope);
+	}
+
+	assert(state.has_value()
+		&& "Not a valid entity");
 
 	mScene.mEntityManager->FreeId(this, mId);
-	EntityId tmpId;
-	myScope.GetVariable("id") >> tmpId;
-	mId = mScene.mEntityManager->AllocId(this, tmpId);
+	mId = mScene.mEntityManager->AllocId(this, state->mId);
+	ResetRandomSeed();
 
-	mTransform.Deserialize(myScope, mScene);
+	if (state->mParentOwnerId.has_value())
+	{
+		mScene.mEntityManager->ResolveParentOnceLoaded(state->mParentOwnerId.value(), mTransform);
+	}
+
+	mTransform.SetLocalPosition(state->mLocalPosition);
+	mTransform.SetLocalOrientation(state->mLocalOrientation);
+	mTransform.SetLocalScale(state->mLocalScale);
 
 	if (mCollisionObject != nullptr)
 	{
 		mCollisionObject->activate();
 		mCollisionObject->setWorldTransform(mTransform.ToBullet());
+		mCollisionObject->setInterpolationWorldTransform(mCollisionObject->getWorldTransform());
 
 		btRigidBody* myRigidBody = dynamic_cast<btRigidBody*>(mCollisionObject.get());
-		if (myRigidBody != nullptr)
+		if (myRigidBody != nullptr
+			&& state->mHasRigidBody)
 		{
 			myRigidBody->clearForces();
 			myRigidBody->clearGravity();
 
-			const Data::Scope& rigidBodyScope = parentScope.GetScope("RigidBody");
+			myRigidBody->setLinearVelocity(Math::ToBullet(state->mLinearVelocity));
+			myRigidBody->setAngularVelocity(Math::ToBullet(state->mAngularVelocity));
+			myRigidBody->applyCentralForce(Math::ToBullet(state->mForce));
+		}
+	}
+}
+
+std::optional<Framework::Entity::SavedState> Framework::Entity::DecodeSavedState(const Data::Scope& parentScope)
+{
+	const std::optional<const Data::Scope*> myScope = parentScope.TryGetScope("Entity", false);
+	if (!myScope.has_value())
+	{
+		return {};
+	}
+
+	const std::optional<const Data::Scope*> transformScope = myScope.value()->TryGetScope("Transform", false);
+	const std::optional<const Data::Variable*> id = myScope.value()->TryGetVariablePtr("id", false);
+	if (!transformScope.has_value()
+		|| !id.has_value())
+	{
+		return {};
+	}
+
+	const std::optional<const Data::Variable*> position = transformScope.value()->TryGetVariablePtr("p", false);
+	const std::optional<const Data::Variable*> orientation = transformScope.value()->TryGetVariablePtr("o", false);
+	if (!position.has_value()
+		|| !orientation.has_value())
+	{
+		return {};
+	}
+
+	SavedState state{};
+	*id.value() >> state.mId;
+	*position.value() >> state.mLocalPosition;
+	*orientation.value() >> state.mLocalOrientation;
+
+	if (const std::optional<const Data::Variable*> scale = transformScope.value()->TryGetVariablePtr("s", false); scale.has_value())
+	{
+		*scale.value() >> state.mLocalScale;
+	}
 
-			glm::vec3 lVel, aVel, force;
-			rigidBodyScope.GetVariable("lVel") >> lVel;
-			rigidBodyScope.GetVariable("aVel") >> aVel;
-			rigidBodyScope.GetVariable("force") >> force;
+	if (const std::optional<const Data::Variable*> parentOwnerId = transformScope.value()->TryGetVariablePtr("parentOwnerId", false); parentOwnerId.has_value())
+	{
+		EntityId tmp;
+		*parentOwnerId.value() >> tmp;
+		state.mParentOwnerId = tmp;
+	}
 
-			myRigidBody->setLinearVelocity(Math::ToBullet(lVel));
-			myRigidBody->setAngularVelocity(Math::ToBullet(aVel));
-			myRigidBody->applyCentralForce(Math::ToBullet(force));
+	const std::optional<const Data::Scope*> rigidBodyScope = parentScope.TryGetScope("RigidBody", false);
+	if (rigidBodyScope.has_value())
+	{
+		const std::optional<const Data::Variable*> linearVelocity = rigidBodyScope.value()->TryGetVariablePtr("lVel", false);
+		const std::optional<const Data::Variable*> angularVelocity = rigidBodyScope.value()->TryGetVariablePtr("aVel", false);
+		const std::optional<const Data::Variable*> force = rigidBodyScope.value()->TryGetVariablePtr("force", false);
+		if (!linearVelocity.has_value()
+			|| !angularVelocity.has_value()
+			|| !force.has_value())
+		{
+			return {};
 		}
+
+		state.mHasRigidBody = true;
+		*linearVelocity.value() >> state.mLinearVelocity;
+		*angularVelocity.value() >> state.mAngularVelocity;
+		*force.value() >> state.mForce;
+	}
+
+	return state;
+}
+
+uint64_t Framework::Entity::CalculateTransformHash() const
+{
+	uint64_t hash = Math::Hash(mTransform.GetLocalPosition());
+	hash = Math::Hash(mTransform.GetLocalOrientation(), hash);
+	hash = Math::Hash(mTransform.GetLocalScale(), hash);
+
+	const Transform* parent = mTransform.GetParent();
+	const EntityId parentOwnerId = parent != nullptr && parent->GetOwner() != nullptr ? static_cast<EntityId>(parent->GetOwner()->GetId()) : EntityId{};
+	hash = Math::Hash(parentOwnerId, hash);
+
+	const btRigidBody* myRigidBody = dynamic_cast<const btRigidBody*>(mCollisionObject.get());
+
+	if (myRigidBody != nullptr)
+	{
+		hash = Math::Hash(Math::ToGLM(myRigidBody->getLinearVelocity()), hash);
+		hash = Math::Hash(Math::ToGLM(myRigidBody->getAngularVelocity()), hash);
+		hash = Math::Hash(Math::ToGLM(myRigidBody->getTotalForce()), hash);
 	}
+	return hash;
 }
 
-void Framework::Entity::DrawOwnerAndChildren(const Transform& transform, const glm::mat4& worldMatrix, Camera& camera)
+void Framework::Entity::DrawOwnerAndChildren(const Transform& transform, Camera& camera)
 {
 	Entity* owner = transform.GetOwner();
 
@@ -124,12 +231,12 @@ void Framework::Entity::DrawOwnerAndChildren(const Transform& transform, const g
 		
 		if (meshId.has_value())
 		{
-			camera.RequestInstanceDraw(meshId.value(), worldMatrix);
+			camera.RequestInstanceDraw(meshId.value(), transform.GetWorldMatrix());
 		}
 	}
 
 	for (const Transform* child : transform.GetChildren())
 	{
-		DrawOwnerAndChildren(*child, worldMatrix * child->GetLocalMatrix(), camera);
+		DrawOwnerAndChildren(*child, camera);
 	}
 }
\ No newline at end of file
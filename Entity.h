@@ -1,5 +1,7 @@
 #pragma once
 #include "Transform.h"
+#include "ObjectPool.h"
+#include "CollisionObjectStorage.h"
 #include <typeindex>
 
 #define ENTITYMAKER(className)																															\
@@ -11,6 +13,9 @@ public:																																					\
 				inline std::type_index GetTypeIndex() const override { return typeid(className); }														\
 			};																																			\
 		inline virtual std::type_index GetTypeIndex() const { return typeid(className); }																\
+		/* Entities of this type are allocated from their own pool, see ObjectPool. */																	\
+		static inline void* operator new(const size_t size) { return Framework::ObjectPool<className>::Allocate(size); }								\
+		static inline void operator delete(void* ptr, const size_t size) { Framework::ObjectPool<className>::Free(ptr, size); }							\
 private:																																				\
 
 namespace Framework
@@ -63,6 +68,10 @@ namespace Framework
 		void AttemptFixedTick();
 		inline bool HasFixedTick() const { return mHasFixedTick; }
 
+		// In deterministic mode, only these are ticked every frame instead of in fixed steps. Meant for entities that handle input,
+		// they should only affect the simulation through the commands they give.
+		inline bool IsTickedEveryFrame() const { return mIsTickedEveryFrame; }
+
 		virtual void OnCollision(const btCollisionObject*) {};
 		inline bool HasCollisionCallback() const { return mHasCollisionCallback; }
 
@@ -72,25 +81,56 @@ namespace Framework
 		virtual bool Serialize(Data::Scope& parentScope) const;
 		virtual void Deserialize(const Data::Scope& parentScope);
 
+		// Everything Entity::Deserialize reads from a save. Decoding it does not touch the entity or the scene, so it can happen on any thread.
+		struct SavedState
+		{
+			EntityId mId{};
+			std::optional<EntityId> mParentOwnerId{};
+
+			glm::vec3 mLocalPosition{};
+			glm::quat mLocalOrientation = { 1.0f, 0.0f, 0.0f, 0.0f };
+			glm::vec3 mLocalScale = { 1.0f, 1.0f, 1.0f };
+
+			bool mHasRigidBody{};
+			glm::vec3 mLinearVelocity{};
+			glm::vec3 mAngularVelocity{};
+			glm::vec3 mForce{};
+		};
+		// Returns nothing if the scope is missing any of the required data.
+		static std::optional<SavedState> DecodeSavedState(const Data::Scope& parentScope);
+
+		// Delta saves skip the entities that have not changed since the last keyframe. Entities that save more than their transform and
+		// rigid body return true, those are compared by serializing them. Everything else only has to hash its transform.
+		inline virtual bool HasStateBesidesTransform() const { return false; }
+		uint64_t CalculateTransformHash() const;
+
 		inline btCollisionObject* GetCollisionObject() const { return mCollisionObject.get(); }
 		inline const std::optional<MeshId>& GetMeshId() const { return mMeshId; }
 
 		inline Scene& GetScene() const { return mScene; }
 
 	protected:
-		static void DrawOwnerAndChildren(const Transform& transform, const glm::mat4& worldMatrix, Camera& camera);
+		static void DrawOwnerAndChildren(const Transform& transform, Camera& camera);
 
 		static constexpr float sFixedStepSize = 0.2f;
 		bool mHasFixedTick{};
 		bool mHasCollisionCallback{};
+		bool mIsTickedEveryFrame{};
+
+		// Use this instead of the global seed for anything that affects the simulation, so the outcome does not depend on the order in which entities tick.
+		// Derived from the id and the scene's seed.
+		uint mRandomSeed{};
 
 		std::optional<MeshId> mMeshId{};
 
 		Scene& mScene;
 
-		std::unique_ptr<btCollisionObject> mCollisionObject{};
+		// Usually constructed in a CollisionObjectStorage of the derived entity.
+		CollisionObjectPtr mCollisionObject{};
 
 	private:
+		void ResetRandomSeed();
+
 		EntityIdWrapper mId;
 		Transform mTransform{};
 
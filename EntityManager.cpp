@@ -3,10 +3,13 @@
 
 #include <typeinfo>
 #include <typeindex>
+#include <unordered_set>
 
 #include "Scope.h"
 
 #include "Scene.h"
+#include "JobSystem.h"
+#include "Profiler.h"
 
 Framework::EntityManager::EntityManager(Scene& scene) :
 	mScene(scene)
@@ -21,26 +24,113 @@ Framework::EntityManager::~EntityManager()
 
 void Framework::EntityManager::Tick()
 {
-	while (!mIdRequests.empty())
+	PROFILE_ZONE("EntityManager::Tick");
+
+	for (uint i = 0; i < mEntities.size(); i++)
+	{
+		TickEntity(*mEntities[i]);
+	}
+}
+
+void Framework::EntityManager::TickSimulatedEntities()
+{
+	PROFILE_ZONE("EntityManager::TickSimulatedEntities");
+
+	for (uint i = 0; i < mEntities.size(); i++)
 	{
-		const IdRequest& request = mIdRequests.front();
-		
-		Entity* entity = GetEntity(request.mId);
-		request.mCallback(*entity, request.mSecondParam);
-		mIdRequests.pop();
+		if (!mEntities[i]->IsTickedEveryFrame())
+		{
+			TickEntity(*mEntities[i]);
+		}
 	}
+}
+
+void Framework::EntityManager::TickEntitiesTickedEveryFrame()
+{
+	PROFILE_ZONE("EntityManager::TickEntitiesTickedEveryFrame");
 
 	for (uint i = 0; i < mEntities.size(); i++)
 	{
-		Entity* entity = mEntities[i].get();
+		if (mEntities[i]->IsTickedEveryFrame())
+		{
+			TickEntity(*mEntities[i]);
+		}
+	}
+}
+
+static void CallTick(Framework::Entity& entity)
+{
+	if (entity.HasFixedTick())
+	{
+		entity.AttemptFixedTick();
+	}
+
+	entity.Tick();
+}
+
+void Framework::EntityManager::TickEntity(Entity& entity)
+{
+	if (!mTickCosts.IsEnabled())
+	{
+		CallTick(entity);
+		return;
+	}
+
+	const std::type_index type = entity.GetTypeIndex();
+	const TickCostTracker::Clock::time_point start = TickCostTracker::Clock::now();
+	const AllocationTracker::Counters allocationsAtStart = AllocationTracker::GetOnThisThread();
+
+	CallTick(entity);
+
+	mTickCosts.AddTick(type, TickCostTracker::Clock::now() - start, AllocationTracker::GetOnThisThread() - allocationsAtStart);
+}
+
+void Framework::EntityManager::UpdateWorldMatrices()
+{
+	PROFILE_ZONE("EntityManager::UpdateWorldMatrices");
+
+	if (mIsTransformOrderOutdated
+		|| mTransformOrderVersion != Transform::GetHierarchyVersion())
+	{
+		mTransformsInHierarchyOrder.clear();
+
+		for (const std::unique_ptr<Entity>& entity : mEntities)
+		{
+			if (entity->GetTransform().IsOrphan())
+			{
+				mTransformsInHierarchyOrder.push_back(&entity->GetTransform());
+			}
+		}
 
-		if (entity->HasFixedTick())
+		// Breadth first, the children are added after everything that is already in the list, including their parent.
+		for (size_t i = 0; i < mTransformsInHierarchyOrder.size(); i++)
 		{
-			entity->AttemptFixedTick();
+			for (const Transform* child : mTransformsInHierarchyOrder[i]->GetChildren())
+			{
+				mTransformsInHierarchyOrder.push_back(child);
+			}
 		}
 
-		entity->Tick();
+		mTransformOrderVersion = Transform::GetHierarchyVersion();
+		mIsTransformOrderOutdated = false;
+	}
+
+	for (const Transform* transform : mTransformsInHierarchyOrder)
+	{
+		transform->UpdateWorldMatrix();
+	}
+}
+
+uint64_t Framework::EntityManager::CalculateStateHash() const
+{
+	uint64_t hash = Math::sEmptyHash;
+
+	for (const std::unique_ptr<Entity>& entity : mEntities)
+	{
+		hash = Math::Hash(static_cast<EntityId>(entity->GetId()), hash);
+		hash = Math::Hash(entity->CalculateTransformHash(), hash);
 	}
+	return hash;
 }
 
 void Framework::EntityManager::DrawEntities() const
@@ -163,38 +253,198 @@ void Framework::EntityManager::Serialize(Framework::Data::Scope& parentScope) co
 
 	for (const std::unique_ptr<Entity>& entity : mEntities)
 	{
-		const char* typeName = entity->GetTypeIndex().name();
-		if (sFactories.find(typeName) == sFactories.end())
+		SerializeEntity(*entity, myScope);
+	}
+}
+
+void Framework::EntityManager::SerializeKeyframe(Framework::Data::Scope& parentScope)
+{
+	Data::Scope& myScope = parentScope.AddChild("EntityManager");
+
+	mKeyframeHashes.clear();
+
+	for (const std::unique_ptr<Entity>& entity : mEntities)
+	{
+		if (!SerializeEntity(*entity, myScope))
 		{
-			// We can't deserialize this, so don't bother serializing it.
 			continue;
 		}
 
-		Data::Scope& entityScope = myScope.AddChild(typeName);
+		mKeyframeHashes[entity->GetId()] = entity->HasStateBesidesTransform() ? myScope.GetChildren().back().CalculateHash() : entity->CalculateTransformHash();
+	}
+}
+
+void Framework::EntityManager::SerializeDelta(Framework::Data::Scope& parentScope) const
+{
+	Data::Scope& myScope = parentScope.AddChild("EntityManager");
 
-		bool neededSerialization = entity->Serialize(entityScope);
+	std::vector<EntityId> removedIds{};
 
-		if (!neededSerialization)
+	for (const auto& [id, hash] : mKeyframeHashes)
+	{
+		if (!TryGetEntity(id).has_value())
 		{
-			LOGWARNING("Do we really need a factory for " << typeName << "?");
-			// Because we're not serializing this, we should remove our assigned parent scope to make the save size smaller.
-			myScope.RemoveScope(typeName);
+			removedIds.push_back(id);
+		}
+	}
+	myScope.AddVariable("removedIds") << removedIds;
+
+	for (const std::unique_ptr<Entity>& entity : mEntities)
+	{
+		auto keyframeHash = mKeyframeHashes.find(entity->GetId());
+
+		if (keyframeHash == mKeyframeHashes.end())
+		{
+			SerializeEntity(*entity, myScope);
+			continue;
+		}
+
+		// Most entities never move (trees for example), hashing their transform is all that is needed to skip them.
+		if (!entity->HasStateBesidesTransform())
+		{
+			if (entity->CalculateTransformHash() != keyframeHash->second)
+			{
+				SerializeEntity(*entity, myScope);
+			}
+			continue;
+		}
+
+		if (SerializeEntity(*entity, myScope)
+			&& myScope.GetChildren().back().CalculateHash() == keyframeHash->second)
+		{
+			myScope.GetChildren().pop_back();
 		}
 	}
 }
 
+bool Framework::EntityManager::ApplyDelta(Framework::Data::Scope& parentScope, Framework::Data::Scope& keyframeParentScope)
+{
+	std::optional<Data::Scope*> myOptionalScope = parentScope.TryGetScope("EntityManager");
+	std::optional<Data::Scope*> keyframeOptionalScope = keyframeParentScope.TryGetScope("EntityManager");
+	if (!myOptionalScope.has_value()
+		|| !keyframeOptionalScope.has_value())
+	{
+		LOGWARNING("Could not apply the delta save to the entityManager, data missing");
+		return false;
+	}
+	Data::Scope& myScope = *myOptionalScope.value();
+	Data::Scope& keyframeScope = *keyframeOptionalScope.value();
+
+	std::vector<EntityId> removedIdsList{};
+	myScope.GetVariable("removedIds") >> removedIdsList;
+	const std::unordered_set<EntityId> removedIds(removedIdsList.begin(), removedIdsList.end());
+
+	const auto getId = [](const Data::Scope& entityScope)
+		{
+			EntityId id;
+			entityScope.GetScope("Entity").GetVariable("id") >> id;
+			return id;
+		};
+
+	std::vector<Data::Scope> changedEntities = std::move(myScope.GetChildren());
+	myScope.GetChildren().clear();
+	myScope.GetChildren().reserve(keyframeScope.GetChildren().size() + changedEntities.size());
+
+	std::unordered_map<EntityId, size_t> changedIndices{};
+	for (size_t i = 0; i < changedEntities.size(); i++)
+	{
+		changedIndices[getId(changedEntities[i])] = i;
+	}
+	std::vector<bool> isChangedEntityUsed(changedEntities.size());
+
+	// The order of the keyframe is kept, entities that changed take the place of their old state.
+	for (Data::Scope& entityScope : keyframeScope.GetChildren())
+	{
+		const EntityId id = getId(entityScope);
+
+		if (removedIds.find(id) != removedIds.end())
+		{
+			continue;
+		}
+
+		if (auto changed = changedIndices.find(id); changed != changedIndices.end())
+		{
+			myScope.AddChild(std::move(changedEntities[changed->second]));
+			isChangedEntityUsed[changed->second] = true;
+		}
+		else
+		{
+			myScope.AddChild(std::move(entityScope));
+		}
+	}
+	keyframeScope.Clear();
+
+	// What is left was added after the keyframe.
+	for (size_t i = 0; i < changedEntities.size(); i++)
+	{
+		if (!isChangedEntityUsed[i])
+		{
+			myScope.AddChild(std::move(changedEntities[i]));
+		}
+	}
+	return true;
+}
+
+bool Framework::EntityManager::SerializeEntity(const Entity& entity, Framework::Data::Scope& myScope) const
+{
+	const char* typeName = entity.GetTypeIndex().name();
+	if (sFactories.find(typeName) == sFactories.end())
+	{
+		// We can't deserialize this, so don't bother serializing it.
+		return false;
+	}
+
+	Data::Scope& entityScope = myScope.AddChild(typeName);
+
+	bool neededSerialization = entity.Serialize(entityScope);
+
+	if (!neededSerialization)
+	{
+		LOGWARNING("Do we really need a factory for " << typeName << "?");
+		// Because we're not serializing this, we should remove our assigned parent scope to make the save size smaller.
+		myScope.RemoveScope(typeName);
+		return false;
+	}
+	return true;
+}
+
 float Framework::EntityManager::Deserialize(const Framework::Data::Scope& parentScope, const EntityId maxNumOfToDeserialze)
 {
 	std::optional<const Data::Scope*> myOptionalScope = parentScope.TryGetScope("EntityManager");
 	if (!myOptionalScope.has_value())
 	{
 		LOGWARNING("Could not load in entityManager from file, data missing");
+		ResolveReferences();
 		return 1.0f;
 	}
 
 
 	const Data::Scope& myScope = *myOptionalScope.value();
 	const std::vector<Data::Scope>& savedEntities = myScope.GetChildren();
+
+	if (savedEntities.empty())
+	{
+		ResolveReferences();
+		return 1.0f;
+	}
+
+	// Decoding only reads from the entity's own scope, which allows every entity to be decoded in parallel.
+	// Allocating the ids and creating the physics objects is left for the construction below, on this thread.
+	if (mAmountDeserialized == 0)
+	{
+		mDecodedStates.resize(savedEntities.size());
+
+		JobSystem::Inst().ParallelFor(savedEntities.size(),
+			[this, &savedEntities](const size_t index)
+			{
+				const Data::Scope& entityScope = savedEntities[index];
+
+				if (sFactories.find(entityScope.GetName()) != sFactories.end())
+				{
+					mDecodedStates[index] = Entity::DecodeSavedState(entityScope);
+				}
+			});
+	}
 	
 	EntityId amountDeserializedThisCycle{};
 
@@ -203,8 +453,18 @@ float Framework::EntityManager::Deserialize(const Framework::Data::Scope& parent
 		const Data::Scope& entityScope = savedEntities[i];
 		const std::string& type = entityScope.GetName();
 
+		if (!mDecodedStates[i].has_value())
+		{
+			LOGWARNING("Skipping " << type << " in the save, it is not a valid entity");
+			continue;
+		}
+
 		std::unique_ptr<Entity> entity = sFactories.at(type)->Create(mScene);
+
+		mDecodedStateBeingDeserialized = std::move(mDecodedStates[i]);
 		entity->Deserialize(entityScope);
+		assert(!mDecodedStateBeingDeserialized.has_value()
+			&& "Entity::Deserialize was not called");
 
 		// Saves time on assigned new ids, since it has to go over less duplicates
 		mNextIdToGive = std::max(mNextIdToGive, static_cast<EntityId>(entity->GetId() + 1u));
@@ -213,13 +473,41 @@ float Framework::EntityManager::Deserialize(const Framework::Data::Scope& parent
 	}
 	mAmountDeserialized += amountDeserializedThisCycle;
 
+	if (mAmountDeserialized == savedEntities.size())
+	{
+		mDecodedStates = {};
+		ResolveReferences();
+	}
+
 	const float percentageGenerated = static_cast<float>(mAmountDeserialized) / static_cast<float>(savedEntities.size());
 	return percentageGenerated;
 }
 
-void Framework::EntityManager::DelayedIdRequest(const EntityId id, std::function<void(Entity&, void*)> callback, void* secondParam)
+void Framework::EntityManager::ResolveParentOnceLoaded(const EntityId parentOwnerId, Transform& child)
 {
-	mIdRequests.emplace(id, std::move(callback), secondParam);
+	mPendingReferences.push_back({ parentOwnerId, &child,
+		[](void* target, Entity& referenced)
+		{
+			static_cast<Transform*>(target)->SetParent(&referenced.GetTransform());
+		} });
+}
+
+void Framework::EntityManager::ResolveReferences()
+{
+	for (const PendingReference& reference : mPendingReferences)
+	{
+		auto it = mEntityLookUp.find(reference.mId);
+
+		if (it == mEntityLookUp.end())
+		{
+			LOGWARNING("Entity " << reference.mId << " is referred to in the save, but does not exist");
+			continue;
+		}
+
+		reference.mResolve(reference.mTarget, *it->second);
+	}
+
+	mPendingReferences = {};
 }
 
 void Framework::EntityManager::Clear()
@@ -1,5 +1,7 @@
 #pragma once
 #include "Entity.h"
+#include "TickCostTracker.h"
+#include <utility>
 
 namespace Framework
 {
@@ -21,6 +23,21 @@ namespace Framework
 		void Tick();
 		void DrawEntities() const;
 
+		// Brings the world matrix of every transform in the hierarchy up to date in one pass, parents before their children.
+		// The transforms would otherwise be updated one by one when they are first used.
+		void UpdateWorldMatrices();
+
+		// Used in deterministic mode instead of Tick, the simulated entities are ticked in fixed steps, the others every frame.
+		void TickSimulatedEntities();
+		void TickEntitiesTickedEveryFrame();
+
+		// Only covers the transforms and rigid bodies, in the order the entities were added.
+		uint64_t CalculateStateHash() const;
+
+		// How long each type of entity took to tick, the scene ends a frame after every tick.
+		inline TickCostTracker& GetTickCosts() { return mTickCosts; }
+		inline const TickCostTracker& GetTickCosts() const { return mTickCosts; }
+
 		template<typename T, typename ...Args>
 		inline T& AddEntity(Args && ...args);
 		
@@ -44,21 +61,37 @@ namespace Framework
 		// Does not preserve order
 		void RemoveInvalidIds(std::vector<EntityId>& ids) const;
 
-		template<typename DerivedFromEntity>
-		static inline std::vector<EntityId> ConvertToEntityIds(const std::vector<DerivedFromEntity*>& entities);
+		template<typename DerivedFromEntity, typename Allocator>
+		static inline std::vector<EntityId> ConvertToEntityIds(const std::vector<DerivedFromEntity*, Allocator>& entities);
 
 		// Does not check to see if the unit that the id belongs to is actually of that type, it just does a static cast.
 		template<typename T>
 		inline std::vector<T*> ConvertToType(const std::vector<EntityId>& ids) const;
 
-		template<typename OfType>
-		inline std::vector<OfType*> GetEntities() const;
+		// Pass a FrameAllocator if the result is only needed during this frame.
+		template<typename OfType, typename Allocator = std::allocator<OfType*>>
+		inline std::vector<OfType*, Allocator> GetEntities() const;
 
 		void Serialize(Framework::Data::Scope& parentScope) const;
+
+		// The same as Serialize, but remembers the state of every entity for the delta saves that follow.
+		void SerializeKeyframe(Framework::Data::Scope& parentScope);
+		// Only contains the entities that changed or were added since the last keyframe, along with the ids of those that have been removed since.
+		void SerializeDelta(Framework::Data::Scope& parentScope) const;
+		// Turns the entities in a delta save back into the complete list, by applying them on top of the keyframe. The keyframe is left empty.
+		static bool ApplyDelta(Framework::Data::Scope& parentScope, Framework::Data::Scope& keyframeParentScope);
+
 		float Deserialize(const Framework::Data::Scope& parentScope, const EntityId maxNumOfToDeserialze = std::numeric_limits<EntityId>::max());
 
-		// Will wait with looking for the id until the start of the next frame.
-		void DelayedIdRequest(const EntityId id, std::function<void(Entity&, void*)> callback, void* secondParam = nullptr);
+		// Only has a value while an entity is being loaded from a save, see Entity::Deserialize.
+		inline std::optional<Entity::SavedState> TakeDecodedState() { return std::exchange(mDecodedStateBeingDeserialized, {}); }
+
+		// While loading, the entity that an id refers to might not have been loaded yet. These register what needs to point
+		// to that entity instead, and all of them are resolved in one pass once the last entity has been loaded.
+		// The field is left as it is if the entity turns out to be of a different type, an id from a stale save may have been reused.
+		template<typename T>
+		inline void ResolveOnceLoaded(const EntityId id, T*& field);
+		void ResolveParentOnceLoaded(const EntityId parentOwnerId, Transform& child);
 
 		template<typename T>
 		static void BuildFactory();
@@ -66,6 +99,11 @@ namespace Framework
 		void Clear();
 
 	private:
+		void TickEntity(Entity& entity);
+
+		// Returns false if the entity does not need to be saved, nothing is added in that case.
+		bool SerializeEntity(const Entity& entity, Framework::Data::Scope& myScope) const;
+
 		Scene& mScene;
 
 		std::vector<std::unique_ptr<Entity>> mEntities{};
@@ -75,23 +113,38 @@ namespace Framework
 
 		EntityId mNextIdToGive = 1;
 
+		TickCostTracker mTickCosts{};
+
+		// Every transform of every entity, and the transforms attached to them, with each parent before its children.
+		std::vector<const Transform*> mTransformsInHierarchyOrder{};
+		uint64_t mTransformOrderVersion{};
+		bool mIsTransformOrderOutdated = true;
+
 #ifdef DEBUG
 		// Only used to check if an entity has already requested to be removed.
 		std::vector<EntityId> mToRemoveAsVector{};
 #endif // DEBUG
 
-		struct IdRequest
+		void ResolveReferences();
+
+		struct PendingReference
 		{
-			IdRequest(EntityId id, std::function<void(Entity&, void*)> callBack, void* secondParm) : mId(id), mCallback(std::move(callBack)), mSecondParam(secondParm) {}
-			const EntityId mId{};
-			const std::function<void(Entity&, void*)> mCallback{};
-			void* const mSecondParam{};
+			EntityId mId{};
+			void* mTarget{};
+			void (*mResolve)(void* target, Entity& referenced){};
 		};
-		std::queue<IdRequest> mIdRequests{};
+		std::vector<PendingReference> mPendingReferences{};
 
 		// Needed for serialization
 		static inline std::unordered_map<std::string, std::unique_ptr<Entity::FactoryBase>> sFactories{};
 		EntityId mAmountDeserialized{};
+
+		// Every saved entity is decoded at once on all cores, after which they are constructed a few at a time.
+		std::vector<std::optional<Entity::SavedState>> mDecodedStates{};
+		std::optional<Entity::SavedState> mDecodedStateBeingDeserialized{};
+
+		// The hash of each entity that was in the last keyframe, see Entity::HasStateBesidesTransform.
+		std::unordered_map<EntityId, uint64_t> mKeyframeHashes{};
 	};
 
 	template<typename T, typename ...Args>
@@ -105,11 +158,12 @@ namespace Framework
 	{
 		T* rawPtr = entity.get();
 		mEntities.push_back(std::move(entity));
+		mIsTransformOrderOutdated = true;
 		return *rawPtr;
 	}
 
-	template<typename DerivedFromEntity>
-	inline std::vector<EntityId> EntityManager::ConvertToEntityIds(const std::vector<DerivedFromEntity*>& entities)
+	template<typename DerivedFromEntity, typename Allocator>
+	inline std::vector<EntityId> EntityManager::ConvertToEntityIds(const std::vector<DerivedFromEntity*, Allocator>& entities)
 	{
 		std::vector<EntityId> ids(entities.size());
 
@@ -134,10 +188,10 @@ namespace Framework
 		return ofType;
 	}
 
-	template<typename OfType>
-	inline std::vector<OfType*> EntityManager::GetEntities() const
+	template<typename OfType, typename Allocator>
+	inline std::vector<OfType*, Allocator> EntityManager::GetEntities() const
 	{
-		std::vector<OfType*> found{};
+		std::vector<OfType*, Allocator> found{};
 		found.reserve(mEntities.size());
 
 		for (const std::unique_ptr<Entity>& entity : mEntities)
@@ -152,6 +206,26 @@ namespace Framework
 		return found;
 	}
 
+	template<typename T>
+	inline void EntityManager::ResolveOnceLoaded(const EntityId id, T*& field)
+	{
+		static_assert(std::is_base_of_v<Entity, std::remove_const_t<T>>);
+
+		mPendingReferences.push_back({ id, &field,
+			[](void* target, Entity& referenced)
+			{
+				T* const asType = dynamic_cast<T*>(&referenced);
+
+				if (asType == nullptr)
+				{
+					LOGWARNING("Entity " << referenced.GetId() << " is referred to as a " << typeid(T).name() << ", but is a " << referenced.GetTypeIndex().name());
+					return;
+				}
+
+				*static_cast<T**>(target) = asType;
+			} });
+	}
+
 	template<typename T>
 	inline void EntityManager::BuildFactory()
 	{
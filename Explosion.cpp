@@ -32,11 +32,11 @@ RTS::Explosion::Explosion(Framework::Scene& scene, const Framework::Transform& t
 		mGrowSpeed *= 1.0f / meshRadius;
 
 		myTransform.SetLocalScale(glm::vec3{ meshRadius });
-		myTransform.SetLocalOrientation(Framework::Random::Range(-PI, PI), Framework::Random::Range(-PI, PI), Framework::Random::Range(-PI, PI));
+		myTransform.SetLocalOrientation(Framework::Random::Range(-PI, PI, mRandomSeed), Framework::Random::Range(-PI, PI, mRandomSeed), Framework::Random::Range(-PI, PI, mRandomSeed));
 		ApplyForcesAndDamage(explosionRadius, explosionForce);
 	}
 
-	mCollisionObject = std::make_unique<btCollisionObject>();
+	mCollisionObject = mCollisionObjectStorage.Construct();
 	mCollisionObject->setCollisionShape(&mCollisionShape);
 	mCollisionObject->setWorldTransform(myTransform.ToBullet());
 	mCollisionObject->setUserPointer(this);
@@ -22,6 +22,7 @@ namespace RTS
 
         bool Serialize(Framework::Data::Scope& parentScope) const override;
         void Deserialize(const Framework::Data::Scope& parentScope) override;
+        inline bool HasStateBesidesTransform() const override { return true; }
 
     private:
         void ApplyForcesAndDamage(const float explosionRadius, const float explosionForce);
@@ -29,6 +30,7 @@ namespace RTS
         std::shared_ptr<Framework::AnimatedMesh> mMesh{};
         std::unique_ptr<Framework::Animator> mAnimator{};
         btSphereShape mCollisionShape;
+        Framework::CollisionObjectStorage<btCollisionObject> mCollisionObjectStorage{};
 
         float mGrowSpeed = 4.0f;
     };
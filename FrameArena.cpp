@@ -0,0 +1,54 @@
+#include "precomp.h"
+#include "FrameArena.h"
+
+Framework::FrameArena::FrameArena()
+{
+	mBlocks.push_back(std::unique_ptr<std::byte[]>(new std::byte[sInitialCapacity]));
+	mBlockSizes.push_back(sInitialCapacity);
+	mCapacity = sInitialCapacity;
+}
+
+void* Framework::FrameArena::Allocate(const size_t size, const size_t alignment)
+{
+	size_t start = (mNumOfBytesUsed + alignment - 1) / alignment * alignment;
+
+	if (start + size > mBlockSizes.back())
+	{
+		// The blocks are allocated with new, which aligns them to at least alignof(std::max_align_t).
+		assert(alignment <= alignof(std::max_align_t));
+
+		const size_t blockSize = std::max(size, mBlockSizes.back() * 2);
+		mBlocks.push_back(std::unique_ptr<std::byte[]>(new std::byte[blockSize]));
+		mBlockSizes.push_back(blockSize);
+		mCapacity += blockSize;
+
+		mNumOfBytesUsedInEarlierBlocks += mNumOfBytesUsed;
+		start = 0;
+	}
+
+	mNumOfBytesUsed = start + size;
+	return mBlocks.back().get() + start;
+}
+
+void Framework::FrameArena::Reset()
+{
+	if (mBlocks.size() > 1)
+	{
+		size_t totalSize{};
+
+		for (const size_t blockSize : mBlockSizes)
+		{
+			totalSize += blockSize;
+		}
+
+		mBlocks.clear();
+		mBlockSizes.clear();
+
+		mBlocks.push_back(std::unique_ptr<std::byte[]>(new std::byte[totalSize]));
+		mBlockSizes.push_back(totalSize);
+		mCapacity = totalSize;
+	}
+
+	mNumOfBytesUsed = 0;
+	mNumOfBytesUsedInEarlierBlocks = 0;
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+#include "Singleton.h"
+
+namespace Framework
+{
+	// Hands out memory for temporaries that are thrown away before the frame ends, by bumping a pointer. Nothing is freed individually,
+	// everything is released at once when the game starts its next frame. Only use it from the main thread, and never keep anything
+	// allocated from it in a member.
+	class FrameArena :
+		public Singleton<FrameArena>
+	{
+	private:
+		friend Singleton;
+		FrameArena();
+		~FrameArena() = default;
+
+	public:
+		void* Allocate(const size_t size, const size_t alignment);
+
+		// Everything that was allocated becomes invalid. If the arena ran out of space during the frame, it grows to fit everything at once,
+		// so that the frames after do not have to allocate from the heap.
+		void Reset();
+
+		inline size_t GetCapacity() const { return mCapacity; }
+		inline size_t GetNumOfBytesUsed() const { return mNumOfBytesUsedInEarlierBlocks + mNumOfBytesUsed; }
+
+	private:
+		static constexpr size_t sInitialCapacity = 1 << 20;
+
+		// The block that is currently being allocated from is the last one, there is only one unless the arena ran out of space.
+		std::vector<std::unique_ptr<std::byte[]>> mBlocks{};
+		std::vector<size_t> mBlockSizes{};
+
+		size_t mCapacity{};
+		size_t mNumOfBytesUsed{};
+		size_t mNumOfBytesUsedInEarlierBlocks{};
+	};
+
+	// Lets the standard containers allocate from the frame arena.
+	template<typename T>
+	class FrameAllocator
+	{
+	public:
+		using value_type = T;
+
+		FrameAllocator() = default;
+
+		template<typename U>
+		FrameAllocator(const FrameAllocator<U>&) {}
+
+		inline T* allocate(const size_t n)
+		{
+			return static_cast<T*>(FrameArena::Inst().Allocate(n * sizeof(T), alignof(T)));
+		}
+
+		inline void deallocate(T*, const size_t) {}
+
+		template<typename U>
+		inline bool operator==(const FrameAllocator<U>&) const { return true; }
+	};
+
+	template<typename T>
+	using FrameVector = std::vector<T, FrameAllocator<T>>;
+}
\ No newline at end of file
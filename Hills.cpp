@@ -2,6 +2,7 @@
 #include "Hills.h"
 
 #include "Chunk.h"
+#include "JobSystem.h"
 
 RTS::Hills::Hills(const uint numOfChunksX, const uint numOfChunksZ, const float maxHeight, const float roughness, const float persistence, const uint octaves) :
 	TerrainData(numOfChunksX, numOfChunksZ),
@@ -11,30 +12,50 @@ RTS::Hills::Hills(const uint numOfChunksX, const uint numOfChunksZ, const float
 	mOctaves(octaves)
 {
 	mPerlin.reseed(Framework::Random::Uint());
-	mIncompleteHeightmap.reserve(mNumOfVerticesX * mNumOfVerticesZ);
 }
 
 float RTS::Hills::GenerateHeightMap(const size_t maxNumOfSamples)
 {
-	size_t vertexIndex = mIncompleteHeightmap.size();
-	size_t samplesTaken{};
+	// The heightmap may have been loaded from the cache instead.
+	if (mNumOfRowsGenerated == mNumOfVerticesZ
+		|| !GetHeightMap().empty())
+	{
+		return 1.0f;
+	}
 
-	for (size_t z = vertexIndex / mNumOfVerticesX; z < mNumOfVerticesZ && samplesTaken < maxNumOfSamples; z++)
+	if (mNumOfRowsGenerated == 0)
 	{
-		for (size_t x = vertexIndex % mNumOfVerticesX; x < mNumOfVerticesX && samplesTaken < maxNumOfSamples; x++, vertexIndex++, samplesTaken++)
-		{
-			const float noise = mPerlin.octave2D_01(static_cast<float>(x) * mRoughness, static_cast<float>(z) * mRoughness, mOctaves, mPersistence);
-			mIncompleteHeightmap.push_back(noise * mMaxHeight);
-		}
+		mIncompleteHeightmap.resize(static_cast<size_t>(mNumOfVerticesX) * static_cast<size_t>(mNumOfVerticesZ));
 	}
 
-	const size_t totalAmountOfVertices = static_cast<size_t>(mNumOfVerticesX) * static_cast<size_t>(mNumOfVerticesZ);
-	const size_t amountLeft = totalAmountOfVertices - vertexIndex;
+	// Rows are never split up, so we always generate at least one.
+	const size_t maxNumOfRows = std::max(maxNumOfSamples / mNumOfVerticesX, static_cast<size_t>(1));
+	const size_t firstRow = mNumOfRowsGenerated;
+	const size_t numOfRows = std::min(maxNumOfRows, mNumOfVerticesZ - firstRow);
+
+	Framework::JobSystem::Inst().ParallelFor(numOfRows,
+		[this, firstRow](const size_t rowIndex)
+		{
+			const size_t z = firstRow + rowIndex;
+			GenerateRow(z, &mIncompleteHeightmap[z * mNumOfVerticesX]);
+		});
+
+	mNumOfRowsGenerated += numOfRows;
 
-	if (amountLeft == 0)
+	if (mNumOfRowsGenerated == mNumOfVerticesZ)
 	{
 		SetHeightMap(std::move(mIncompleteHeightmap));
 	}
 
-	return static_cast<float>(vertexIndex) / static_cast<float>(totalAmountOfVertices);
+	return static_cast<float>(mNumOfRowsGenerated) / static_cast<float>(mNumOfVerticesZ);
 }
+
+void RTS::Hills::GenerateRow(const size_t z, float* row) const
+{
+	mPerlin.octave2DRow_01(row, mNumOfVerticesX, mRoughness, static_cast<float>(z) * mRoughness, static_cast<std::int32_t>(mOctaves), mPersistence);
+
+	for (size_t x = 0; x < mNumOfVerticesX; x++)
+	{
+		row[x] *= mMaxHeight;
+	}
+}
\ No newline at end of file
@@ -13,7 +13,13 @@ namespace RTS
         float GenerateHeightMap(const size_t maxNumOfSamples = std::numeric_limits<size_t>::max()) override;
 
     private:
+        // Only reads from the noise, so rows can be generated on seperate threads.
+        void GenerateRow(const size_t z, float* row) const;
+
+        // Allocated once generation starts, the rows are generated in parallel.
         std::vector<float> mIncompleteHeightmap{};
+        size_t mNumOfRowsGenerated{};
+
         siv::BasicPerlinNoise<float> mPerlin{};
 
         const float mMaxHeight{};
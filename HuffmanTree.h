@@ -13,7 +13,10 @@ namespace Framework::Data
 			FrequencyType mFrequency{};
 		};
 
-		HuffmanTree(const std::list<DataFrequency>& dataFrequencies);
+		// Canonical trees assign the codes based on the code lengths alone, which are limited to sMaxCodeLength.
+		// This allows for table driven decoding. Non-canonical trees encode using the paths through the tree,
+		// which is how .dat files were stored before; those are still decoded through that path.
+		HuffmanTree(const std::list<DataFrequency>& dataFrequencies, const bool canonical = true);
 
 		static void IncrementFrequency(std::list<DataFrequency>& existingFrequencies, const T& dataToIncrement, const FrequencyType incrementBy = 1);
 
@@ -24,9 +27,40 @@ namespace Framework::Data
 		void Serialize(DB::dynamic_bitset& toBitset);
 		static HuffmanTree Deserialize(DB::dynamic_bitset::const_iterator& iterator);
 
+		bool IsCanonical() const { return mIsCanonical; }
+
+		static constexpr unsigned int sMaxCodeLength = 20;
+
+		// The number of bits decoded at once using the lookup table, longer codes are resolved afterwards.
+		static constexpr unsigned int sNumOfLookupBits = 10;
+
 	private:
+		HuffmanTree(std::vector<T>&& symbols, std::vector<uint8_t>&& codeLengths);
+
 		std::vector<DB::bit> CalculatePathTo(const T& data) const;
 
+		std::vector<uint8_t> CalculateLimitedCodeLengths() const;
+		void AssignCanonicalCodes(std::vector<T>&& symbols, std::vector<uint8_t>&& codeLengths);
+
+		const T& DecodeCanonical(DB::dynamic_bitset::const_iterator& iterator) const;
+
+		// Old files start with the number of leaves, which can never be this value.
+		static constexpr size_t sCanonicalMarker = std::numeric_limits<size_t>::max();
+
+		struct CanonicalCode
+		{
+			uint32_t mBits{};
+			uint8_t mLength{};
+		};
+
+		struct LookupEntry
+		{
+			uint32_t mSymbolIndex{};
+
+			// 0 if the code is longer than the number of lookup bits.
+			uint8_t mLength{};
+		};
+
 		class Node
 		{
 		public:
@@ -74,10 +108,26 @@ namespace Framework::Data
 		std::vector<Node> mNodes{};
 		std::unordered_map<T, std::vector<DB::bit>> mPaths{};
 		Node* mRoot{};
+
+		bool mIsCanonical{};
+
+		// Sorted by their code length, the codes are assigned in this order.
+		std::vector<T> mCanonicalSymbols{};
+		std::vector<uint8_t> mCanonicalCodeLengths{};
+		std::unordered_map<T, CanonicalCode> mCanonicalCodes{};
+
+		std::vector<LookupEntry> mLookupTable{};
+		unsigned int mNumOfLookupBits{};
+		unsigned int mLongestCodeLength{};
+
+		// Indexed by code length, used for the codes that do not fit in the lookup table.
+		uint32_t mFirstCodes[sMaxCodeLength + 1]{};
+		uint32_t mFirstSymbolIndices[sMaxCodeLength + 1]{};
+		uint32_t mNumOfCodes[sMaxCodeLength + 1]{};
 	};
 
 	template<typename T, typename FrequencyType>
-	inline HuffmanTree<T, FrequencyType>::HuffmanTree(const std::list<DataFrequency>& dataFrequencies)
+	inline HuffmanTree<T, FrequencyType>::HuffmanTree(const std::list<DataFrequency>& dataFrequencies, const bool canonical)
 	{
 		std::list<size_t> open{};
 
@@ -133,8 +183,30 @@ namespace Framework::Data
 			mNodes.push_back(std::move(parentNode));
 		}
 		mNodes.shrink_to_fit();
+
+		if (mNodes.empty())
+		{
+			mIsCanonical = canonical;
+			return;
+		}
+
 		mRoot = &mNodes[open.front()];
 
+		if (canonical)
+		{
+			std::vector<T> symbols{};
+			for (const Node& node : mNodes)
+			{
+				if (node.mIsLeaf)
+				{
+					symbols.push_back(node.GetData());
+				}
+			}
+
+			AssignCanonicalCodes(std::move(symbols), CalculateLimitedCodeLengths());
+			return;
+		}
+
 		// Now let's calculate the paths to hopefully save some time later on.
 		for (const Node& node : mNodes)
 		{
@@ -145,6 +217,12 @@ namespace Framework::Data
 		}
 	}
 
+	template<typename T, typename FrequencyType>
+	inline HuffmanTree<T, FrequencyType>::HuffmanTree(std::vector<T>&& symbols, std::vector<uint8_t>&& codeLengths)
+	{
+		AssignCanonicalCodes(std::move(symbols), std::move(codeLengths));
+	}
+
 	template<typename T, typename FrequencyType>
 	inline void HuffmanTree<T, FrequencyType>::IncrementFrequency(std::list<DataFrequency>& existingFrequencies, const T& dataToIncrement, const FrequencyType incrementBy)
 	{
@@ -173,6 +251,21 @@ namespace Framework::Data
 	template<typename T, typename FrequencyType>
 	inline void HuffmanTree<T, FrequencyType>::Encode(DB::dynamic_bitset& toBitset, const T& data)
 	{
+		if (mIsCanonical)
+		{
+			const auto codeIt = mCanonicalCodes.find(data);
+
+			if (codeIt == mCanonicalCodes.end())
+			{
+				assert(false
+					&& "Data was not part of the frequencies this tree was constructed with");
+				return;
+			}
+
+			toBitset.push_back_bits(codeIt->second.mBits, codeIt->second.mLength);
+			return;
+		}
+
 		auto it = mPaths.find(data);
 
 		if (it == mPaths.end())
@@ -189,6 +282,11 @@ namespace Framework::Data
 	template<typename T, typename FrequencyType>
 	inline const T& HuffmanTree<T, FrequencyType>::Decode(DB::dynamic_bitset::const_iterator& startFrom) const
 	{
+		if (mIsCanonical)
+		{
+			return DecodeCanonical(startFrom);
+		}
+
 		const Node* currentNode = mRoot;
 		while (true)
 		{
@@ -206,6 +304,20 @@ namespace Framework::Data
 	template<typename T, typename FrequencyType>
 	inline void HuffmanTree<T, FrequencyType>::Serialize(DB::dynamic_bitset& toBitset)
 	{
+		if (mIsCanonical)
+		{
+			// The code lengths are all that's needed to reconstruct the codes.
+			toBitset.push_back(sCanonicalMarker);
+			toBitset.push_back(mCanonicalSymbols.size());
+
+			for (size_t i = 0; i < mCanonicalSymbols.size(); i++)
+			{
+				toBitset.push_back(mCanonicalCodeLengths[i]);
+				toBitset.push_back(mCanonicalSymbols[i]);
+			}
+			return;
+		}
+
 		// It's cheapest and easiest to just save the frequencies and the data, since that's all the information we need to construct a huffman tree.
 		size_t numOfLeaves{};
 
@@ -236,6 +348,22 @@ namespace Framework::Data
 	{
 		size_t numOfLeaves = DB::dynamic_bitset::extract<size_t>(iterator);
 
+		if (numOfLeaves == sCanonicalMarker)
+		{
+			const size_t numOfSymbols = DB::dynamic_bitset::extract<size_t>(iterator);
+
+			std::vector<T> symbols{};
+			std::vector<uint8_t> codeLengths{};
+
+			for (size_t i = 0; i < numOfSymbols && iterator < iterator.GetSource()->end(); i++)
+			{
+				codeLengths.push_back(DB::dynamic_bitset::extract<uint8_t>(iterator));
+				symbols.push_back(DB::dynamic_bitset::extract<T>(iterator));
+			}
+
+			return HuffmanTree<T, FrequencyType>(std::move(symbols), std::move(codeLengths));
+		}
+
 		std::list<DataFrequency> frequencies{};
 
 		for (size_t i = 0; i < numOfLeaves; i++)
@@ -245,7 +373,7 @@ namespace Framework::Data
 			frequencies.push_back({ std::move(data), frequency });
 		}
 
-		return HuffmanTree<T, FrequencyType>(frequencies);
+		return HuffmanTree<T, FrequencyType>(frequencies, false);
 	}
 
 	template<typename T, typename FrequencyType>
@@ -306,4 +434,212 @@ namespace Framework::Data
 			&& "Could not find a path");
 		return std::vector<DB::bit>();
 	}
+
+	template<typename T, typename FrequencyType>
+	inline std::vector<uint8_t> HuffmanTree<T, FrequencyType>::CalculateLimitedCodeLengths() const
+	{
+		// The depth of each leaf is its code length.
+		std::vector<size_t> depths(mNodes.size());
+		std::vector<size_t> open{ mRoot->mIndex };
+		size_t deepest{};
+
+		while (!open.empty())
+		{
+			const Node& node = mNodes[open.back()];
+			open.pop_back();
+
+			if (node.mIsLeaf)
+			{
+				deepest = std::max(deepest, depths[node.mIndex]);
+				continue;
+			}
+
+			for (const bool rightChild : { false, true })
+			{
+				const size_t childIndex = node.GetChildIndex(rightChild);
+				depths[childIndex] = depths[node.mIndex] + 1;
+				open.push_back(childIndex);
+			}
+		}
+
+		std::vector<size_t> numOfCodesPerLength(std::max<size_t>(deepest, sMaxCodeLength) + 1);
+		std::vector<size_t> leaves{};
+
+		for (const Node& node : mNodes)
+		{
+			if (node.mIsLeaf)
+			{
+				// A tree with a single leaf would otherwise get a code without any bits.
+				++numOfCodesPerLength[std::max<size_t>(depths[node.mIndex], 1)];
+				leaves.push_back(node.mIndex);
+			}
+		}
+
+		// Move the leaves that are too deep up the tree. Since the tree is full, the deepest level always holds pairs of
+		// leaves; one of them takes the place of their parent, the other is paired with a leaf from a shallower level.
+		for (size_t length = deepest; length > sMaxCodeLength; length--)
+		{
+			while (numOfCodesPerLength[length] > 0)
+			{
+				size_t shallower = length - 2;
+				while (numOfCodesPerLength[shallower] == 0)
+				{
+					--shallower;
+				}
+
+				numOfCodesPerLength[length] -= 2;
+				numOfCodesPerLength[length - 1] += 1;
+				numOfCodesPerLength[shallower + 1] += 2;
+				numOfCodesPerLength[shallower] -= 1;
+			}
+		}
+
+		// The most frequent data gets the shortest codes.
+		std::stable_sort(leaves.begin(), leaves.end(),
+			[this](size_t index1, size_t index2)
+			{
+				return mNodes[index1].mFrequency > mNodes[index2].mFrequency;
+			});
+
+		std::vector<uint8_t> codeLengthsPerLeaf(mNodes.size());
+		size_t length = 1;
+
+		for (const size_t leafIndex : leaves)
+		{
+			while (numOfCodesPerLength[length] == 0)
+			{
+				++length;
+			}
+
+			--numOfCodesPerLength[length];
+			codeLengthsPerLeaf[leafIndex] = static_cast<uint8_t>(length);
+		}
+
+		// Return them in the same order as the leaves are stored in.
+		std::vector<uint8_t> codeLengths{};
+		for (const Node& node : mNodes)
+		{
+			if (node.mIsLeaf)
+			{
+				codeLengths.push_back(codeLengthsPerLeaf[node.mIndex]);
+			}
+		}
+
+		return codeLengths;
+	}
+
+	template<typename T, typename FrequencyType>
+	inline void HuffmanTree<T, FrequencyType>::AssignCanonicalCodes(std::vector<T>&& symbols, std::vector<uint8_t>&& codeLengths)
+	{
+		assert(symbols.size() == codeLengths.size());
+
+		mIsCanonical = true;
+
+		std::vector<size_t> order(symbols.size());
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			order[i] = i;
+		}
+
+		std::stable_sort(order.begin(), order.end(),
+			[&codeLengths](size_t index1, size_t index2)
+			{
+				return codeLengths[index1] < codeLengths[index2];
+			});
+
+		mCanonicalSymbols.reserve(symbols.size());
+		mCanonicalCodeLengths.reserve(symbols.size());
+
+		for (const size_t index : order)
+		{
+			const uint8_t length = codeLengths[index];
+
+			if (length == 0
+				|| length > sMaxCodeLength)
+			{
+				LOGWARNING("Invalid huffman code length, the data will not be decodable.");
+				continue;
+			}
+
+			mCanonicalSymbols.push_back(std::move(symbols[index]));
+			mCanonicalCodeLengths.push_back(length);
+			++mNumOfCodes[length];
+		}
+
+		if (mCanonicalSymbols.empty())
+		{
+			return;
+		}
+
+		mLongestCodeLength = mCanonicalCodeLengths.back();
+		mNumOfLookupBits = std::min(sNumOfLookupBits, mLongestCodeLength);
+
+		uint32_t code{};
+		uint32_t symbolIndex{};
+		for (unsigned int length = 1; length <= sMaxCodeLength; length++)
+		{
+			mFirstCodes[length] = code;
+			mFirstSymbolIndices[length] = symbolIndex;
+
+			code = (code + mNumOfCodes[length]) << 1;
+			symbolIndex += mNumOfCodes[length];
+		}
+
+		mLookupTable.resize(size_t{ 1 } << mNumOfLookupBits);
+		mCanonicalCodes.reserve(mCanonicalSymbols.size());
+
+		for (size_t i = 0; i < mCanonicalSymbols.size(); i++)
+		{
+			const uint8_t length = mCanonicalCodeLengths[i];
+			const uint32_t bits = mFirstCodes[length] + static_cast<uint32_t>(i - mFirstSymbolIndices[length]);
+
+			mCanonicalCodes[mCanonicalSymbols[i]] = { bits, length };
+
+			if (length <= mNumOfLookupBits)
+			{
+				// Every entry that starts with this code decodes to it.
+				const unsigned int numOfUnusedBits = mNumOfLookupBits - length;
+				const size_t firstEntry = static_cast<size_t>(bits) << numOfUnusedBits;
+				const size_t numOfEntries = size_t{ 1 } << numOfUnusedBits;
+
+				for (size_t entry = firstEntry; entry < firstEntry + numOfEntries && entry < mLookupTable.size(); entry++)
+				{
+					mLookupTable[entry] = { static_cast<uint32_t>(i), length };
+				}
+			}
+		}
+	}
+
+	template<typename T, typename FrequencyType>
+	inline const T& HuffmanTree<T, FrequencyType>::DecodeCanonical(DB::dynamic_bitset::const_iterator& startFrom) const
+	{
+		assert(!mCanonicalSymbols.empty());
+
+		const uint64_t bits = DB::dynamic_bitset::peek_bits(startFrom, mLongestCodeLength);
+		const LookupEntry& entry = mLookupTable[static_cast<size_t>(bits >> (mLongestCodeLength - mNumOfLookupBits))];
+
+		if (entry.mLength != 0)
+		{
+			startFrom += entry.mLength;
+			return mCanonicalSymbols[entry.mSymbolIndex];
+		}
+
+		for (unsigned int length = mNumOfLookupBits + 1; length <= mLongestCodeLength; length++)
+		{
+			const uint32_t code = static_cast<uint32_t>(bits >> (mLongestCodeLength - length));
+			const uint32_t indexWithinLength = code - mFirstCodes[length];
+
+			if (code >= mFirstCodes[length]
+				&& indexWithinLength < mNumOfCodes[length])
+			{
+				startFrom += length;
+				return mCanonicalSymbols[mFirstSymbolIndices[length] + indexWithinLength];
+			}
+		}
+
+		assert(false
+			&& "Invalid huffman code");
+		startFrom += mLongestCodeLength;
+		return mCanonicalSymbols.front();
+	}
 }
\ No newline at end of file
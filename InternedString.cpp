@@ -0,0 +1,64 @@
+#include "precomp.h"
+#include "InternedString.h"
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+// The strings are never removed, and a deque never moves its elements when growing at the end,
+// so their addresses stay the same for as long as the program runs. The keys are views into those same strings.
+static std::deque<std::string> sStorage{};
+static std::unordered_map<std::string_view, const std::string*> sStrings{};
+static std::shared_mutex sStringsMutex{};
+
+Framework::Data::InternedString::InternedString(std::string_view string)
+{
+	if (string.empty())
+	{
+		return;
+	}
+
+	{
+		std::shared_lock lock{ sStringsMutex };
+
+		const auto it = sStrings.find(string);
+		if (it != sStrings.end())
+		{
+			mString = it->second;
+			return;
+		}
+	}
+
+	std::unique_lock lock{ sStringsMutex };
+
+	// Another thread may have interned it in between the two locks.
+	const auto it = sStrings.find(string);
+	if (it != sStrings.end())
+	{
+		mString = it->second;
+		return;
+	}
+
+	const std::string& stored = sStorage.emplace_back(string);
+	sStrings.emplace(stored, &stored);
+	mString = &stored;
+}
+
+std::optional<Framework::Data::InternedString> Framework::Data::InternedString::TryFind(std::string_view string)
+{
+	if (string.empty())
+	{
+		return InternedString{};
+	}
+
+	std::shared_lock lock{ sStringsMutex };
+
+	const auto it = sStrings.find(string);
+	if (it == sStrings.end())
+	{
+		return {};
+	}
+
+	return InternedString{ it->second };
+}
\ No newline at end of file
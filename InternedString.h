@@ -0,0 +1,34 @@
+#pragma once
+
+namespace Framework::Data
+{
+	// A string that is stored only once, no matter how many scopes or variables use it.
+	// Comparing and hashing only looks at the address of that one copy. Interning is thread safe.
+	class InternedString
+	{
+	public:
+		InternedString() = default;
+		InternedString(std::string_view string);
+
+		// Does not intern the string if it has not been interned yet; nothing can be using it in that case.
+		static std::optional<InternedString> TryFind(std::string_view string);
+
+		inline const std::string& GetString() const { return *mString; }
+
+		inline bool operator==(const InternedString& other) const { return mString == other.mString; }
+		inline bool operator!=(const InternedString& other) const { return mString != other.mString; }
+
+		inline size_t GetHash() const
+		{
+			// Addresses are aligned and close together, spread them out over all the bits.
+			const uint64_t hash = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(mString) >> 4) * 0x9E3779B97F4A7C15ull;
+			return static_cast<size_t>(hash ^ (hash >> 29));
+		}
+
+	private:
+		explicit InternedString(const std::string* string) : mString(string) {}
+
+		static inline const std::string sEmpty{};
+		const std::string* mString = &sEmpty;
+	};
+}
\ No newline at end of file
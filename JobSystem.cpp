@@ -0,0 +1,123 @@
+#include "precomp.h"
+#include "JobSystem.h"
+
+#include "Profiler.h"
+
+Framework::JobSystem::JobSystem()
+{
+	// hardware_concurrency is allowed to return 0 if it cannot be determined.
+	const uint numOfCores = std::max(std::thread::hardware_concurrency(), 1u);
+
+	// The workers record their jobs in the profiler, constructing it first makes sure it outlives them.
+	Profiler::Inst();
+
+	for (uint i = 1; i < numOfCores; i++)
+	{
+		mWorkers.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+}
+
+Framework::JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(mJobsMutex);
+		mShuttingDown = true;
+	}
+	mJobAvailable.notify_all();
+
+	for (std::thread& worker : mWorkers)
+	{
+		worker.join();
+	}
+}
+
+void Framework::JobSystem::ParallelFor(const size_t count, const std::function<void(size_t)>& job)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	// Workers might only get to their part after this function has returned, if all the work has already been done
+	// by then. The state is shared so that it outlives this function, the job itself is never called in that case.
+	struct SharedState
+	{
+		std::atomic<size_t> mNextIndex{};
+		std::atomic<size_t> mNumOfCompleted{};
+	};
+	std::shared_ptr<SharedState> state = std::make_shared<SharedState>();
+	const std::function<void(size_t)>* const jobPtr = &job;
+
+	const std::function<void()> work = [state, jobPtr, count]()
+	{
+		for (size_t index = state->mNextIndex++; index < count; index = state->mNextIndex++)
+		{
+			(*jobPtr)(index);
+			state->mNumOfCompleted++;
+		}
+	};
+
+	const size_t numOfHelpers = std::min(mWorkers.size(), count - 1);
+
+	if (numOfHelpers != 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mJobsMutex);
+
+			for (size_t i = 0; i < numOfHelpers; i++)
+			{
+				mJobs.push(work);
+			}
+		}
+		mJobAvailable.notify_all();
+	}
+
+	work();
+
+	// The other threads may still be finishing up their last index.
+	while (state->mNumOfCompleted.load() < count)
+	{
+		std::this_thread::yield();
+	}
+}
+
+void Framework::JobSystem::Schedule(std::function<void()> job)
+{
+	if (mWorkers.empty())
+	{
+		job();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mJobsMutex);
+		mJobs.push(std::move(job));
+	}
+	mJobAvailable.notify_one();
+}
+
+void Framework::JobSystem::WorkerLoop(const uint workerIndex)
+{
+	Profiler::Inst().SetThreadName("Worker " + std::to_string(workerIndex));
+
+	while (true)
+	{
+		std::function<void()> job{};
+
+		{
+			std::unique_lock<std::mutex> lock(mJobsMutex);
+			mJobAvailable.wait(lock, [this] { return mShuttingDown || !mJobs.empty(); });
+
+			if (mJobs.empty())
+			{
+				return;
+			}
+
+			job = std::move(mJobs.front());
+			mJobs.pop();
+		}
+
+		PROFILE_ZONE("Job");
+		job();
+	}
+}
\ No newline at end of file
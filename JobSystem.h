@@ -0,0 +1,43 @@
+#pragma once
+#include "Singleton.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace Framework
+{
+	// A small pool of worker threads, one for each core besides the main thread.
+	class JobSystem :
+		public Singleton<JobSystem>
+	{
+	private:
+		friend Singleton;
+		JobSystem();
+		~JobSystem();
+
+	public:
+		// Calls job(index) for every index in [0, count), spread out over the workers. The calling thread
+		// helps out as well, and this function only returns once every index has been completed.
+		void ParallelFor(const size_t count, const std::function<void(size_t)>& job);
+
+		// Hands the job to one of the workers and returns right away. Runs the job on the calling thread instead if there are no workers.
+		// Jobs that are still queued when the game shuts down are finished first, anything the job uses has to stay alive until then.
+		void Schedule(std::function<void()> job);
+
+		// Including the thread that calls ParallelFor.
+		inline uint GetNumOfThreads() const { return static_cast<uint>(mWorkers.size()) + 1u; }
+
+	private:
+		void WorkerLoop(const uint workerIndex);
+
+		std::vector<std::thread> mWorkers{};
+
+		std::queue<std::function<void()>> mJobs{};
+		std::mutex mJobsMutex{};
+		std::condition_variable mJobAvailable{};
+
+		bool mShuttingDown{};
+	};
+}
\ No newline at end of file
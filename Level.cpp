@@ -8,6 +8,7 @@
 #include "Hills.h"
 #include "Forest.h"
 #include "Terrain.h"
+#include "TerrainCache.h"
 #include "Scope.h"
 #include "Army.h"
 #include "Player.h"
@@ -19,12 +20,18 @@
 #include "AssetManager.h"
 #include "ImguiHelpers.h"
 #include "TimeManager.h"
+#include "JobSystem.h"
+#include "Settings.h"
+#include "Replay.h"
 
 RTS::Level::Level(Framework::Game& game, const std::string& levelFile, const std::string& levelName) :
-	Scene(game, levelFile, levelName)
+	Scene(game, levelFile, levelName),
+	mLevelFile(levelFile)
 {
 	mLevelGeneration = mSceneData->TryGetScope("LevelGeneration");
 	mEndscreen = Framework::AssetManager::Inst().GetAsset<Framework::Sprite>("data/sprites/endscreen.txt");
+
+	Framework::Settings::Inst().GetSettings().GetVariable("autosaveInterval") >> mAutosaveInterval;
 }
 
 RTS::Level::~Level() = default;
@@ -68,7 +75,29 @@ void RTS::Level::Tick()
 
 	if (!mIsPaused)
 	{
+		if (mFastForwardToStep > GetNumOfStepsTaken())
+		{
+			FastForward(mFastForwardToStep);
+			mFastForwardToStep = 0;
+
+			if (mEntityManager->GetTickCosts().IsEnabled())
+			{
+				mEntityManager->GetTickCosts().Dump("profiles/tickcosts_" + GenerateSaveName() + ".csv");
+			}
+		}
+
 		Scene::Tick();
+
+		if (mAutosaveInterval > 0.0f
+			&& mVictoryState == VictoryState::none)
+		{
+			mTimeSinceAutosave += Framework::TimeManager::GetRawDeltaTime();
+
+			if (mTimeSinceAutosave >= mAutosaveInterval)
+			{
+				Autosave();
+			}
+		}
 	}
 }
 
@@ -97,6 +126,7 @@ uchar RTS::Level::Deserialize(const uchar progress)
 			terrainScope.GetVariable("octaves") >> octaves;
 
 			Framework::Random::Seed(seed);
+			SetRandomSeed(seed);
 
 			std::unique_ptr<Hills> hills = std::make_unique<Hills>(
 				numOfChunks.x,
@@ -107,6 +137,20 @@ uchar RTS::Level::Deserialize(const uchar progress)
 				octaves
 				);
 
+			uint64_t cacheKey = Framework::TerrainCache::sEmptyKey;
+			cacheKey = Framework::TerrainCache::AppendToKey(cacheKey, numOfChunks);
+			cacheKey = Framework::TerrainCache::AppendToKey(cacheKey, seed);
+			cacheKey = Framework::TerrainCache::AppendToKey(cacheKey, maxHeight);
+			cacheKey = Framework::TerrainCache::AppendToKey(cacheKey, roughness);
+			cacheKey = Framework::TerrainCache::AppendToKey(cacheKey, persistence);
+			cacheKey = Framework::TerrainCache::AppendToKey(cacheKey, octaves);
+
+			// Hills is still constructed when the cache is used, so the random number generator ends up in the same state.
+			if (!Framework::TerrainCache::Load(cacheKey, *hills))
+			{
+				mTerrainCacheKeyToSave = cacheKey;
+			}
+
 			mTerrain->SetTerrainData(std::move(hills));
 			
 			const Framework::Data::Scope& forestScope = levelData->GetScope("Forest");
@@ -140,10 +184,16 @@ uchar RTS::Level::Deserialize(const uchar progress)
 		{
 			constexpr uchar progressStart = 2;
 			constexpr uchar progressEnd = 30;
-			const float dataProgress = mTerrain->GetData()->GenerateHeightMap(2500);
+			// The heightmap is generated on all cores, so each of them can take the same amount of samples per step.
+			const float dataProgress = mTerrain->GetData()->GenerateHeightMap(2500 * Framework::JobSystem::Inst().GetNumOfThreads());
 
 			if (dataProgress == 1.0f)
 			{
+				if (mTerrainCacheKeyToSave.has_value())
+				{
+					Framework::TerrainCache::Save(mTerrainCacheKeyToSave.value(), *mTerrain->GetData());
+					mTerrainCacheKeyToSave.reset();
+				}
 				return progressEnd + 1;
 			}
 			return static_cast<uchar>(Framework::Math::lerp(static_cast<float>(progressStart), static_cast<float>(progressEnd), dataProgress));
@@ -196,6 +246,13 @@ uchar RTS::Level::Deserialize(const uchar progress)
 			mOpponentArmy->SpawnUnits(opponentScope.GetScope("Army"));
 			mEntityManager->AddEntity<Opponent>(mOpponentArmy->GetId());
 
+			if (mReplay == nullptr
+				&& IsDeterministic()
+				&& RecordsReplays())
+			{
+				mReplay = std::make_unique<Replay>(mLevelFile, GetLevelName());
+			}
+
 			return 100;
 		}
 	}
@@ -246,9 +303,22 @@ void RTS::Level::DrawImGui()
 			{
 				ImGui::InputText("Save name", &mWhatToNameTheSave);
 
+				ImGui::BeginDisabled(IsSaving());
 				if (ImGui::Button("Save"))
 				{
-					Serialize(mWhatToNameTheSave);
+					mSaveStatus = "Saving...";
+					SerializeAsync(mWhatToNameTheSave,
+						[this](bool succeeded)
+						{
+							mSaveStatus = succeeded ? "Saved" : "Could not save";
+						});
+				}
+				ImGui::EndDisabled();
+
+				if (!mSaveStatus.empty())
+				{
+					ImGui::SameLine();
+					ImGui::TextUnformatted(mSaveStatus.c_str());
 				}
 
 				if (ImGui::Button("Return to main menu"))
@@ -343,9 +413,44 @@ void RTS::Level::DrawImGui()
 
 void RTS::Level::Unload()
 {
+	if (mReplay != nullptr
+		&& mReplay->IsRecording()
+		&& mReplay->GetNumOfSteps() != 0)
+	{
+		mReplay->Save("replays/" + GenerateSaveName() + ".replay");
+	}
+
 	Framework::TimeManager::SetTimeScale(1.0f);
 }
 
+void RTS::Level::PlayReplay(std::unique_ptr<Replay> replay, const uint fastForwardToStep)
+{
+	assert(!replay->IsRecording());
+
+	mReplay = std::move(replay);
+	mFastForwardToStep = fastForwardToStep;
+
+	// The replay only matches what happened during the recording if the simulation is deterministic.
+	SetIsDeterministic(true);
+}
+
+void RTS::Level::BeforeStep()
+{
+	if (mReplay != nullptr
+		&& !mReplay->IsRecording())
+	{
+		mReplay->IssueOrders(OrderIssuer::player, *this);
+	}
+}
+
+void RTS::Level::AfterStep()
+{
+	if (mReplay != nullptr)
+	{
+		mReplay->OnStepTaken(GetNumOfStepsTaken(), GetStateHash());
+	}
+}
+
 std::string RTS::Level::GenerateSaveName() const
 {
 	std::string saveName{};
@@ -369,7 +474,15 @@ std::string RTS::Level::GenerateSaveName() const
 	{
 		saveName.append(buff);
 	}
-	
+
+	saveName += GetLevelName();
+
+	return saveName;
+}
+
+// Without the date or other prefix in brackets, if this level was loaded from a save.
+std::string RTS::Level::GetLevelName() const
+{
 	std::string levelName = mSceneData->GetScope().GetName();
 
 	size_t firstClosingBracket = levelName.find_first_of(']');
@@ -379,9 +492,16 @@ std::string RTS::Level::GenerateSaveName() const
 		levelName = levelName.substr(firstClosingBracket + 1);
 	}
 
-	saveName += levelName;
+	return levelName;
+}
 
-	return saveName;
+void RTS::Level::Autosave()
+{
+	// Tried again next tick if the previous save is still being written.
+	if (SerializeAsync("[autosave] " + GetLevelName(), {}, true))
+	{
+		mTimeSinceAutosave = 0.0f;
+	}
 }
 
 void RTS::Level::TogglePause()
@@ -391,5 +511,6 @@ void RTS::Level::TogglePause()
 	if (mIsPaused)
 	{
 		mWhatToNameTheSave = GenerateSaveName();
+		mSaveStatus.clear();
 	}
 }
\ No newline at end of file
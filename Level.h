@@ -16,6 +16,7 @@ namespace RTS
 {
 	class Forest;
 	class Army;
+	class Replay;
 
 	class Level :
 		public Framework::Scene
@@ -31,14 +32,28 @@ namespace RTS
 
 		void Unload() override;
 
+		// Plays back the orders in the replay instead of listening to the player and the opponent, call before loading the level.
+		// The level is fast-forwarded to fastForwardToStep once it has loaded.
+		void PlayReplay(std::unique_ptr<Replay> replay, const uint fastForwardToStep = 0);
+		inline Replay* GetReplay() const { return mReplay.get(); }
+
 	protected:
 		const std::optional<const Framework::Data::Scope*>& GetScopeUsedForLevelGeneration() const { return mLevelGeneration; }
 
 		Army* mPlayerArmy{};
 		Army* mOpponentArmy{};
 
+		void BeforeStep() override;
+		void AfterStep() override;
+
+		// Levels that are played from the start in deterministic mode are recorded, unless this returns false.
+		inline virtual bool RecordsReplays() const { return true; }
+
 	private:
 		std::string GenerateSaveName() const;
+		std::string GetLevelName() const;
+
+		void Autosave();
 
 		void TogglePause();
 
@@ -49,7 +64,20 @@ namespace RTS
 		// Only needed for spawning the trees.
 		std::unique_ptr<Forest> mForest{};
 
+		// Set when the terrain was not in the cache yet, so it can be stored once it has been generated.
+		std::optional<uint64_t> mTerrainCacheKeyToSave{};
+
+		std::string mLevelFile{};
+
+		std::unique_ptr<Replay> mReplay{};
+		uint mFastForwardToStep{};
+
 		std::string mWhatToNameTheSave{};
+		std::string mSaveStatus{};
+
+		// In seconds of real time, 0 if autosaving is disabled.
+		float mAutosaveInterval{};
+		float mTimeSinceAutosave{};
 
 		enum class VictoryState { none = -1, opponentWon, playerWon };
 		VictoryState mVictoryState = VictoryState::none;
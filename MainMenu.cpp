@@ -22,6 +22,7 @@
 #include "Settings.h"
 #include "Texture.h"
 #include "ImguiHelpers.h"
+#include "Replay.h"
 
 RTS::MainMenu::MainMenu(Framework::Game& game) :
 	Level(game, "mainmenu.txt", "mainmenu")
@@ -53,14 +54,42 @@ uchar RTS::MainMenu::Deserialize(const uchar progress)
 
 		{
 			const std::filesystem::path savesPath = sDataRoot +"saves";
-			const size_t savesPathSize = savesPath.string().size();
 
 			for (const std::filesystem::directory_entry& dirEntry : std::filesystem::directory_iterator{ savesPath })
 			{
-				const std::string entryString = dirEntry.path().string();
-				const size_t nameSize = entryString.size() - savesPathSize - 5;
-				std::string name = entryString.substr(savesPathSize + 1, nameSize);
+				// Older saves are still in the huffman encoded .dat format. Anything else, such as the .tmp files left behind by an interrupted save, is skipped.
+				const std::filesystem::path extension = dirEntry.path().extension();
+				if (extension != ".sav"
+					&& extension != ".dat")
+				{
+					continue;
+				}
+
+				// Keyframes are only loaded through the delta saves that refer to them.
+				std::string name = dirEntry.path().stem().string();
+				constexpr std::string_view keyframeSuffix = Framework::Scene::sKeyframeSuffix;
+				if (name.size() >= keyframeSuffix.size()
+					&& name.compare(name.size() - keyframeSuffix.size(), keyframeSuffix.size(), keyframeSuffix) == 0)
+				{
+					continue;
+				}
+
 				mSavesNames.push_back(std::move(name));
+				mSavesFiles.push_back("saves/" + dirEntry.path().filename().string());
+			}
+		}
+
+		{
+			// Only created once the first replay is saved.
+			const std::filesystem::path replaysPath = sDataRoot + "replays";
+			std::error_code error{};
+
+			for (const std::filesystem::directory_entry& dirEntry : std::filesystem::directory_iterator{ replaysPath, error })
+			{
+				if (dirEntry.path().extension() == ".replay")
+				{
+					mReplayNames.push_back(dirEntry.path().stem().string());
+				}
 			}
 		}
 
@@ -168,13 +197,19 @@ void RTS::MainMenu::DrawImGui()
 			}
 
 			ImGui::SetCursorPos({ buttonStart.x, buttonStart.y + 2.0f * (buttonSize.y + spacing) });
+			if (ImGui::Button("Replays", buttonSize))
+			{
+				mActiveMenu = Menu::replays;
+			}
+
+			ImGui::SetCursorPos({ buttonStart.x, buttonStart.y + 3.0f * (buttonSize.y + spacing) });
 			if (ImGui::Button("Settings", buttonSize))
 			{
 				mNewSettings = std::make_unique<Framework::Data::Scope>(Framework::Settings::Inst().GetSettings());
 				mActiveMenu = Menu::settings;
 			}
 			
-			ImGui::SetCursorPos({ buttonStart.x, buttonStart.y + 3.0f * (buttonSize.y + spacing) });
+			ImGui::SetCursorPos({ buttonStart.x, buttonStart.y + 4.0f * (buttonSize.y + spacing) });
 			if (ImGui::Button("Quit to desktop", buttonSize))
 			{
 				mGame.Quit();
@@ -270,8 +305,24 @@ void RTS::MainMenu::DrawImGui()
 			if (ImGui::Button("Start", genericButtonSize)
 				&& mSelectedSave != -1)
 			{
-				const std::string file = "saves/" + mSavesNames[mSelectedSave] + ".dat";
-				mGame.RequestLoadTo(std::make_unique<Level>(mGame, file, mSavesNames[mSelectedSave]));
+				std::unique_ptr<Level> level = std::make_unique<Level>(mGame, mSavesFiles[mSelectedSave], mSavesNames[mSelectedSave]);
+
+				if (level->HasFailedToLoad())
+				{
+					mSaveError = "Could not load " + mSavesNames[mSelectedSave] + ", the keyframe it was saved against is missing.";
+				}
+				else
+				{
+					mGame.RequestLoadTo(std::move(level));
+				}
+			}
+
+			if (!mSaveError.empty())
+			{
+				ImGui::SetCursorPos({ genericSpacing, genericWindowSize.y - (genericSpacing + genericButtonSize.y) * 2.0f });
+				ImGui::PushStyleColor(ImGuiCol_Text, { 1.0f, 0.3f, 0.3f, 1.0f });
+				ImGui::TextUnformatted(mSaveError.c_str());
+				ImGui::PopStyleColor();
 			}
 
 			ImGui::SetCursorPos({ genericWindowSize.x - (genericButtonSize.x + genericSpacing) * 2.0f, genericWindowSize.y - genericSpacing - genericButtonSize.y });
@@ -279,9 +330,11 @@ void RTS::MainMenu::DrawImGui()
 			if (ImGui::Button("Delete", genericButtonSize)
 				&& mSelectedSave != -1)
 			{
-				Framework::Data::SavedData::Delete(std::string{ "saves/" } + mSavesNames[mSelectedSave] + ".dat");
+				Framework::Data::SavedData::Delete(mSavesFiles[mSelectedSave]);
 				mSavesNames.erase(mSavesNames.begin() + mSelectedSave);
+				mSavesFiles.erase(mSavesFiles.begin() + mSelectedSave);
 				mSelectedSave = -1;
+				mSaveError.clear();
 			}
 
 			ImGui::SetCursorPos({ genericWindowSize.x - (genericButtonSize.x + genericSpacing) * 1.0f, genericWindowSize.y - genericSpacing - genericButtonSize.y });
@@ -290,6 +343,75 @@ void RTS::MainMenu::DrawImGui()
 			{
 				mActiveMenu = Menu::main;
 				mSelectedSave = -1;
+				mSaveError.clear();
+			}
+		}
+		ImGui::End();
+	}
+		break;
+	case RTS::MainMenu::Menu::replays:
+	{
+		ImGui::SetNextWindowSize(genericWindowSize);
+		ImGui::SetNextWindowPos(genericWindowPosition);
+
+		if (ImGui::Begin("Replay selector", nullptr, genericWindowFlags))
+		{
+			Framework::ImguiHelpers::SetWindowFontSize(genericContentFontSize);
+
+			for (int i = 0; i < static_cast<int>(mReplayNames.size()); i++)
+			{
+				if (ImGui::Selectable(mReplayNames[i].c_str(), mSelectedReplay == i, 0, wideButtonSize))
+				{
+					mSelectedReplay = i;
+				}
+			}
+
+			Framework::ImguiHelpers::SetWindowFontSize(genericNavigationButtonsFontSize);
+
+			if (mSelectedReplay != -1)
+			{
+				const std::string replayFile = "replays/" + mReplayNames[mSelectedReplay] + ".replay";
+
+				ImGui::SetCursorPos({ genericSpacing, genericWindowSize.y - genericSpacing - genericButtonSize.y });
+				ImGui::SetNextItemWidth(genericButtonSize.x * 2.0f);
+				if (ImGui::InputInt("Skip to step", &mFastForwardToStep))
+				{
+					mFastForwardToStep = std::max(mFastForwardToStep, 0);
+				}
+
+				if (ImGui::IsItemHovered())
+				{
+					ImGui::SetTooltip("Simulates the battle up to this step without drawing it, there are 60 steps in a second.");
+				}
+
+				ImGui::SetCursorPos({ genericWindowSize.x - (genericButtonSize.x + genericSpacing) * 3.0f, genericWindowSize.y - genericSpacing - genericButtonSize.y });
+				if (ImGui::Button("Start", genericButtonSize))
+				{
+					std::unique_ptr<Replay> replay = Replay::Load(replayFile);
+
+					if (replay != nullptr)
+					{
+						std::unique_ptr<Level> level = std::make_unique<Level>(mGame, replay->GetLevelFile(), replay->GetLevelName());
+						level->PlayReplay(std::move(replay), static_cast<uint>(mFastForwardToStep));
+						mGame.RequestLoadTo(std::move(level));
+					}
+				}
+
+				ImGui::SetCursorPos({ genericWindowSize.x - (genericButtonSize.x + genericSpacing) * 2.0f, genericWindowSize.y - genericSpacing - genericButtonSize.y });
+				if (ImGui::Button("Delete", genericButtonSize))
+				{
+					std::error_code error{};
+					std::filesystem::remove(sDataRoot + replayFile, error);
+					mReplayNames.erase(mReplayNames.begin() + mSelectedReplay);
+					mSelectedReplay = -1;
+				}
+			}
+
+			ImGui::SetCursorPos({ genericWindowSize.x - (genericButtonSize.x + genericSpacing) * 1.0f, genericWindowSize.y - genericSpacing - genericButtonSize.y });
+			if (ImGui::Button("Exit", genericButtonSize))
+			{
+				mActiveMenu = Menu::main;
+				mSelectedReplay = -1;
 			}
 		}
 		ImGui::End();
@@ -322,6 +444,22 @@ void RTS::MainMenu::DrawImGui()
 				}
 			}
 
+			{
+				bool tmpBool;
+				Framework::Data::Variable& var = settingsScope.GetVariable("GPU-based Terrain");
+				var >> tmpBool;
+
+				if (ImGui::Checkbox("GPU-based Terrain", &tmpBool))
+				{
+					var << tmpBool;
+				}
+
+				if (ImGui::IsItemHovered())
+				{
+					ImGui::SetTooltip("Draws the terrain in a single call using the heightmap. Uses less memory and loads faster, takes effect on the next level.");
+				}
+			}
+
 			{
 				int currentValue;
 				Framework::Data::Variable& var = settingsScope.GetVariable("maxTextureSize");
@@ -360,6 +498,57 @@ void RTS::MainMenu::DrawImGui()
 				}
 			}
 
+			{
+				float currentValue;
+				Framework::Data::Variable& var = settingsScope.GetVariable("autosaveInterval");
+				var >> currentValue;
+
+				if (ImGui::SliderFloat("Autosave interval", &currentValue, 0.0f, 1800.0f, "%.0f s"))
+				{
+					var << currentValue;
+				}
+
+				if (ImGui::IsItemHovered())
+				{
+					ImGui::SetTooltip("Saves in the background during a battle, 0 disables autosaving. Takes effect on the next level.");
+				}
+			}
+
+			{
+				bool tmpBool;
+				Framework::Data::Variable& var = settingsScope.GetVariable("deterministicSimulation");
+				var >> tmpBool;
+
+				if (ImGui::Checkbox("Deterministic simulation", &tmpBool))
+				{
+					var << tmpBool;
+				}
+
+				if (ImGui::IsItemHovered())
+				{
+					ImGui::SetTooltip("Simulates battles in fixed steps, so the same orders always lead to the same outcome. Takes effect on the next level.");
+				}
+			}
+
+#if BT_THREADSAFE
+			// Bullet's multithreaded classes run everything on the calling thread unless it was built with BT_THREADSAFE.
+			{
+				bool tmpBool;
+				Framework::Data::Variable& var = settingsScope.GetVariable("multithreadedPhysics");
+				var >> tmpBool;
+
+				if (ImGui::Checkbox("Multithreaded physics", &tmpBool))
+				{
+					var << tmpBool;
+				}
+
+				if (ImGui::IsItemHovered())
+				{
+					ImGui::SetTooltip("Spreads the physics over all cores. Collisions may resolve slightly differently between runs, so it is not used for deterministic simulations and replays. Takes effect on the next level.");
+				}
+			}
+#endif // BT_THREADSAFE
+
 			Framework::ImguiHelpers::SetWindowFontSize(genericNavigationButtonsFontSize);
 
 			ImGui::SetCursorPos({ genericWindowSize.x - (genericButtonSize.x + genericSpacing) * 1.0f, genericWindowSize.y - genericSpacing - genericButtonSize.y });
@@ -21,6 +21,9 @@ namespace RTS
         void Tick() override;
         void DrawImGui() override;
 
+    protected:
+        inline bool RecordsReplays() const override { return false; }
+
     private:
         void ReplenishArmies() const;
 
@@ -35,7 +38,7 @@ namespace RTS
         glm::vec2 mCamDir{};
         float mTimeCamDirChanged = -sTimeBetweenCamDirChange;
 
-        enum class Menu : uchar { main, level, saves, settings };
+        enum class Menu : uchar { main, level, saves, replays, settings };
         Menu mActiveMenu = Menu::main;
 
         // Needed for main menu
@@ -47,7 +50,14 @@ namespace RTS
 
         // Needed for save selection
         std::vector<std::string> mSavesNames{};
+        std::vector<std::string> mSavesFiles{};
         int mSelectedSave = -1;
+        std::string mSaveError{};
+
+        // Needed for replay selection
+        std::vector<std::string> mReplayNames{};
+        int mSelectedReplay = -1;
+        int mFastForwardToStep{};
 
         std::unique_ptr<Framework::Data::Scope> mNewSettings{};
     };
@@ -0,0 +1,93 @@
+#include "precomp.h"
+#include "MappedFile.h"
+
+#ifdef PLATFORM_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // PLATFORM_LINUX
+
+Framework::MappedFile::MappedFile(const std::string& filePath)
+{
+#ifdef PLATFORM_LINUX
+	const int file = open(filePath.c_str(), O_RDONLY);
+	if (file == -1)
+	{
+		return;
+	}
+
+	struct stat fileInfo {};
+	if (fstat(file, &fileInfo) == 0
+		&& fileInfo.st_size > 0)
+	{
+		void* data = mmap(nullptr, static_cast<size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+
+		if (data != MAP_FAILED)
+		{
+			mData = static_cast<const std::byte*>(data);
+			mSize = static_cast<size_t>(fileInfo.st_size);
+		}
+		else
+		{
+			LOGWARNING("Could not map " << filePath << " into memory");
+		}
+	}
+
+	// The mapping stays valid after the file has been closed.
+	close(file);
+#elif PLATFORM_WINDOWS
+	mFile = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (mFile == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(mFile, &fileSize)
+		|| fileSize.QuadPart == 0)
+	{
+		return;
+	}
+
+	mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mMapping != nullptr)
+	{
+		mData = static_cast<const std::byte*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+	}
+
+	if (mData != nullptr)
+	{
+		mSize = static_cast<size_t>(fileSize.QuadPart);
+	}
+	else
+	{
+		LOGWARNING("Could not map " << filePath << " into memory");
+	}
+#else
+	static_assert(false, "No memory mapped files for this platform!");
+#endif // PLATFORM_LINUX
+}
+
+Framework::MappedFile::~MappedFile()
+{
+#ifdef PLATFORM_LINUX
+	if (mData != nullptr)
+	{
+		munmap(const_cast<std::byte*>(mData), mSize);
+	}
+#elif PLATFORM_WINDOWS
+	if (mData != nullptr)
+	{
+		UnmapViewOfFile(mData);
+	}
+	if (mMapping != nullptr)
+	{
+		CloseHandle(mMapping);
+	}
+	if (mFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(mFile);
+	}
+#endif // PLATFORM_LINUX
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+namespace Framework
+{
+	// Maps a file into memory as read only, the contents are only paged in when they are accessed.
+	class MappedFile
+	{
+	public:
+		MappedFile(const std::string& filePath);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		// False if the file does not exist or could not be mapped.
+		inline bool IsOpen() const { return mData != nullptr; }
+
+		inline const std::byte* GetData() const { return mData; }
+		inline size_t GetSize() const { return mSize; }
+
+	private:
+		const std::byte* mData{};
+		size_t mSize{};
+
+#ifdef PLATFORM_WINDOWS
+		HANDLE mFile = INVALID_HANDLE_VALUE;
+		HANDLE mMapping{};
+#endif // PLATFORM_WINDOWS
+	};
+}
\ No newline at end of file
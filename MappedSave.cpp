@@ -0,0 +1,651 @@
+#include "precomp.h"
+#include "MappedSave.h"
+
+#include <filesystem>
+
+#include "Scope.h"
+#include "Variable.h"
+#include "MappedFile.h"
+
+// Everything in the file is aligned to this, so the values can be read straight from the mapped memory.
+static constexpr uint64_t sAlignment = 8;
+
+// Far deeper than any save nests, only there to stop a corrupted file from overflowing the stack.
+static constexpr uint32_t sMaxDepth = 256;
+
+enum class SectionType : uint32_t { scope, table };
+
+struct Header
+{
+	uint32_t mMagic{};
+	uint32_t mVersion{};
+	uint64_t mFileSize{};
+	uint64_t mSectionIndexOffset{};
+	uint64_t mStringTableOffset{};
+	uint32_t mNumOfSections{};
+	uint32_t mNumOfStrings{};
+	uint32_t mRootSection{};
+	uint32_t mPadding{};
+};
+
+struct SectionEntry
+{
+	uint64_t mOffset{};
+	SectionType mType{};
+	uint32_t mNameId{};
+};
+
+// A single scope, followed by VariableEntry[mNumOfVariables], uint32_t[mNumOfGroups] (section of each group) and ChildEntry[mNumOfChildren].
+struct ScopeSection
+{
+	uint32_t mNumOfVariables{};
+	uint32_t mNumOfGroups{};
+	uint32_t mNumOfChildren{};
+	uint32_t mPadding{};
+};
+
+struct VariableEntry
+{
+	uint32_t mNameId{};
+	uint32_t mSize{};
+	uint64_t mOffset{};
+};
+
+// The children are stored in groups, this keeps track of the original order.
+struct ChildEntry
+{
+	uint32_t mGroup{};
+	uint32_t mIndexInGroup{};
+};
+
+// Scopes that share the same shape, followed by ShapeNode[mNumOfNodes] and Column[mNumOfColumns].
+// The nodes describe the shape of a single row in depth-first order, starting with the root.
+struct TableSection
+{
+	uint32_t mNumOfRows{};
+	uint32_t mNumOfNodes{};
+	uint32_t mNumOfColumns{};
+	uint32_t mPadding{};
+};
+
+struct ShapeNode
+{
+	uint32_t mNameId{};
+	uint32_t mNumOfVariables{};
+	uint32_t mNumOfChildren{};
+	uint32_t mFirstColumn{};
+};
+
+struct Column
+{
+	uint32_t mNameId{};
+	uint32_t mValueSize{};
+	uint64_t mOffset{};
+};
+
+static uint64_t Align(const uint64_t offset)
+{
+	return (offset + sAlignment - 1) / sAlignment * sAlignment;
+}
+
+class MappedSaveWriter
+{
+public:
+	MappedSaveWriter()
+	{
+		// Filled in once everything else has been written.
+		Append(Header{});
+	}
+
+	uint32_t WriteScope(const Framework::Data::Scope& scope)
+	{
+		const std::vector<Framework::Data::Variable>& variables = scope.GetVariables();
+		const std::vector<Framework::Data::Scope>& children = scope.GetChildren();
+
+		std::vector<VariableEntry> variableEntries{};
+		variableEntries.reserve(variables.size());
+
+		for (const Framework::Data::Variable& variable : variables)
+		{
+			const std::string_view value = variable.GetValue();
+			variableEntries.push_back({ Intern(variable.GetName()), static_cast<uint32_t>(value.size()), AppendBytes(value.data(), value.size()) });
+		}
+
+		// Children with the same shape end up in the same group, in the order in which the shapes first appear.
+		std::vector<std::vector<const Framework::Data::Scope*>> groups{};
+		std::unordered_map<std::string, uint32_t> groupIndices{};
+		std::vector<ChildEntry> childEntries{};
+		childEntries.reserve(children.size());
+
+		for (const Framework::Data::Scope& child : children)
+		{
+			std::string shape{};
+			AppendShape(child, shape);
+
+			auto [it, isNew] = groupIndices.try_emplace(std::move(shape), static_cast<uint32_t>(groups.size()));
+			if (isNew)
+			{
+				groups.emplace_back();
+			}
+
+			std::vector<const Framework::Data::Scope*>& group = groups[it->second];
+			childEntries.push_back({ it->second, static_cast<uint32_t>(group.size()) });
+			group.push_back(&child);
+		}
+
+		std::vector<uint32_t> groupSections{};
+		groupSections.reserve(groups.size());
+
+		for (const std::vector<const Framework::Data::Scope*>& group : groups)
+		{
+			// A single scope is written on its own, so that its children can still be grouped.
+			groupSections.push_back(group.size() == 1 ? WriteScope(*group.front()) : WriteTable(group));
+		}
+
+		const ScopeSection section = { static_cast<uint32_t>(variableEntries.size()), static_cast<uint32_t>(groupSections.size()), static_cast<uint32_t>(childEntries.size()) };
+		const uint64_t offset = Append(section);
+		AppendArray(variableEntries);
+		AppendArray(groupSections);
+		AppendArray(childEntries);
+
+		return AddSection(offset, SectionType::scope, scope.GetName());
+	}
+
+	bool Finish(const uint32_t rootSection, const std::string& filePath)
+	{
+		Header header{};
+		header.mMagic = Framework::Data::MappedSave::sMagic;
+		header.mVersion = Framework::Data::MappedSave::sVersion;
+		header.mRootSection = rootSection;
+		header.mNumOfSections = static_cast<uint32_t>(mSections.size());
+		header.mSectionIndexOffset = AppendArray(mSections);
+
+		// Offsets of each string, with one extra at the end so the size of the last string is known as well.
+		std::vector<uint64_t> stringOffsets{};
+		stringOffsets.reserve(mStrings.size() + 1);
+		std::string stringData{};
+
+		for (const std::string* string : mStrings)
+		{
+			stringOffsets.push_back(stringData.size());
+			stringData += *string;
+		}
+		stringOffsets.push_back(stringData.size());
+
+		header.mNumOfStrings = static_cast<uint32_t>(mStrings.size());
+		header.mStringTableOffset = AppendArray(stringOffsets);
+		AppendBytes(stringData.data(), stringData.size());
+		header.mFileSize = mBytes.size();
+
+		memcpy(mBytes.data(), &header, sizeof(Header));
+
+		// Written to a temporary file first, so a crash while saving never leaves behind a half written save.
+		const std::string temporaryFilePath = filePath + ".tmp";
+		{
+			std::ofstream file(temporaryFilePath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				LOGWARNING("Could not save to " << filePath << ", might be read only.");
+				return false;
+			}
+
+			file.write(mBytes.data(), static_cast<std::streamsize>(mBytes.size()));
+		}
+
+		std::error_code error{};
+		std::filesystem::rename(temporaryFilePath, filePath, error);
+		if (error)
+		{
+			LOGWARNING("Could not move " << temporaryFilePath << " into place: " << error.message());
+			return false;
+		}
+		return true;
+	}
+
+private:
+	uint32_t WriteTable(const std::vector<const Framework::Data::Scope*>& rows)
+	{
+		std::vector<ShapeNode> nodes{};
+		std::vector<Column> columns{};
+		AppendShapeNodes(*rows.front(), nodes, columns);
+
+		// Every row has the same shape, so the n-th variable of each row belongs to the n-th column.
+		std::vector<std::vector<const Framework::Data::Variable*>> rowVariables(rows.size());
+		for (size_t i = 0; i < rows.size(); i++)
+		{
+			rowVariables[i].reserve(columns.size());
+			GatherVariables(*rows[i], rowVariables[i]);
+		}
+
+		for (size_t columnIndex = 0; columnIndex < columns.size(); columnIndex++)
+		{
+			Column& column = columns[columnIndex];
+			column.mOffset = AppendBytes(nullptr, 0);
+
+			for (const std::vector<const Framework::Data::Variable*>& variables : rowVariables)
+			{
+				const std::string_view value = variables[columnIndex]->GetValue();
+				assert(value.size() == column.mValueSize);
+				mBytes.insert(mBytes.end(), value.begin(), value.end());
+			}
+		}
+
+		const TableSection section = { static_cast<uint32_t>(rows.size()), static_cast<uint32_t>(nodes.size()), static_cast<uint32_t>(columns.size()) };
+		const uint64_t offset = Append(section);
+		AppendArray(nodes);
+		AppendArray(columns);
+
+		return AddSection(offset, SectionType::table, rows.front()->GetName());
+	}
+
+	// Two scopes have the same shape if they have the same names, and their values are of the same size.
+	void AppendShape(const Framework::Data::Scope& scope, std::string& shape)
+	{
+		const auto appendNumber = [&shape](const uint32_t number)
+			{
+				shape.append(reinterpret_cast<const char*>(&number), sizeof(uint32_t));
+			};
+
+		appendNumber(Intern(scope.GetName()));
+		appendNumber(static_cast<uint32_t>(scope.GetVariables().size()));
+		appendNumber(static_cast<uint32_t>(scope.GetChildren().size()));
+
+		for (const Framework::Data::Variable& variable : scope.GetVariables())
+		{
+			appendNumber(Intern(variable.GetName()));
+			appendNumber(static_cast<uint32_t>(variable.GetValue().size()));
+		}
+
+		for (const Framework::Data::Scope& child : scope.GetChildren())
+		{
+			AppendShape(child, shape);
+		}
+	}
+
+	void AppendShapeNodes(const Framework::Data::Scope& scope, std::vector<ShapeNode>& nodes, std::vector<Column>& columns)
+	{
+		nodes.push_back({ Intern(scope.GetName()), static_cast<uint32_t>(scope.GetVariables().size()), static_cast<uint32_t>(scope.GetChildren().size()), static_cast<uint32_t>(columns.size()) });
+
+		for (const Framework::Data::Variable& variable : scope.GetVariables())
+		{
+			columns.push_back({ Intern(variable.GetName()), static_cast<uint32_t>(variable.GetValue().size()) });
+		}
+
+		for (const Framework::Data::Scope& child : scope.GetChildren())
+		{
+			AppendShapeNodes(child, nodes, columns);
+		}
+	}
+
+	static void GatherVariables(const Framework::Data::Scope& scope, std::vector<const Framework::Data::Variable*>& variables)
+	{
+		for (const Framework::Data::Variable& variable : scope.GetVariables())
+		{
+			variables.push_back(&variable);
+		}
+
+		for (const Framework::Data::Scope& child : scope.GetChildren())
+		{
+			GatherVariables(child, variables);
+		}
+	}
+
+	uint32_t Intern(const std::string& string)
+	{
+		auto [it, isNew] = mStringIds.try_emplace(string, static_cast<uint32_t>(mStrings.size()));
+		if (isNew)
+		{
+			mStrings.push_back(&it->first);
+		}
+		return it->second;
+	}
+
+	uint32_t AddSection(const uint64_t offset, const SectionType type, const std::string& name)
+	{
+		mSections.push_back({ offset, type, Intern(name) });
+		return static_cast<uint32_t>(mSections.size() - 1);
+	}
+
+	// Returns the offset the data was written at.
+	uint64_t AppendBytes(const void* data, const size_t size)
+	{
+		mBytes.resize(Align(mBytes.size()));
+		const uint64_t offset = mBytes.size();
+
+		const char* bytes = static_cast<const char*>(data);
+		mBytes.insert(mBytes.end(), bytes, bytes + size);
+		return offset;
+	}
+
+	template<typename T>
+	uint64_t Append(const T& value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		return AppendBytes(&value, sizeof(T));
+	}
+
+	template<typename T>
+	uint64_t AppendArray(const std::vector<T>& values)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		return AppendBytes(values.data(), values.size() * sizeof(T));
+	}
+
+	std::vector<char> mBytes{};
+
+	// The keys of an unordered_map never move, so the strings can be pointed to.
+	std::unordered_map<std::string, uint32_t> mStringIds{};
+	std::vector<const std::string*> mStrings{};
+
+	std::vector<SectionEntry> mSections{};
+};
+
+class MappedSaveReader
+{
+public:
+	MappedSaveReader(const Framework::MappedFile& file) :
+		mFile(file)
+	{
+	}
+
+	bool Read(Framework::Data::Scope& globalScope)
+	{
+		Header header{};
+		if (!Read(0, header)
+			|| header.mMagic != Framework::Data::MappedSave::sMagic
+			|| header.mVersion != Framework::Data::MappedSave::sVersion
+			|| header.mFileSize != mFile.GetSize())
+		{
+			return false;
+		}
+
+		mSections.resize(header.mNumOfSections);
+		if (!ReadArray(header.mSectionIndexOffset, mSections)
+			|| header.mRootSection >= mSections.size())
+		{
+			return false;
+		}
+		mIsSectionRead.resize(mSections.size());
+
+		std::vector<uint64_t> stringOffsets(static_cast<size_t>(header.mNumOfStrings) + 1);
+		if (!ReadArray(header.mStringTableOffset, stringOffsets))
+		{
+			return false;
+		}
+
+		const uint64_t stringDataOffset = Align(header.mStringTableOffset + stringOffsets.size() * sizeof(uint64_t));
+		mStrings.reserve(header.mNumOfStrings);
+
+		for (uint32_t i = 0; i < header.mNumOfStrings; i++)
+		{
+			const uint64_t size = stringOffsets[i + 1] - stringOffsets[i];
+			if (!IsInFile(stringDataOffset + stringOffsets[i], size))
+			{
+				return false;
+			}
+			mStrings.emplace_back(std::string_view{ reinterpret_cast<const char*>(mFile.GetData() + stringDataOffset + stringOffsets[i]), static_cast<size_t>(size) });
+		}
+
+		return ReadScope(header.mRootSection, globalScope, 0);
+	}
+
+private:
+	// A table section whose header and shape have been read, the values are read from the columns row by row.
+	struct Table
+	{
+		TableSection mSection{};
+		std::vector<ShapeNode> mNodes{};
+		std::vector<Column> mColumns{};
+	};
+
+	bool ReadScope(const uint32_t sectionIndex, Framework::Data::Scope& scope, const uint32_t depth)
+	{
+		// Every scope is written to a section of its own, a section that is read twice can only come from a corrupted file.
+		if (sectionIndex >= mSections.size()
+			|| mSections[sectionIndex].mType != SectionType::scope
+			|| mIsSectionRead[sectionIndex]
+			|| depth >= sMaxDepth)
+		{
+			return false;
+		}
+		mIsSectionRead[sectionIndex] = true;
+
+		uint64_t offset = mSections[sectionIndex].mOffset;
+
+		ScopeSection section{};
+		if (!Read(offset, section))
+		{
+			return false;
+		}
+		offset = Align(offset + sizeof(ScopeSection));
+
+		std::vector<VariableEntry> variableEntries(section.mNumOfVariables);
+		std::vector<uint32_t> groupSections(section.mNumOfGroups);
+		std::vector<ChildEntry> childEntries(section.mNumOfChildren);
+
+		if (!ReadArray(offset, variableEntries))
+		{
+			return false;
+		}
+		offset = Align(offset + variableEntries.size() * sizeof(VariableEntry));
+
+		if (!ReadArray(offset, groupSections))
+		{
+			return false;
+		}
+		offset = Align(offset + groupSections.size() * sizeof(uint32_t));
+
+		if (!ReadArray(offset, childEntries))
+		{
+			return false;
+		}
+
+		scope.GetVariables().reserve(variableEntries.size());
+		for (const VariableEntry& entry : variableEntries)
+		{
+			if (entry.mNameId >= mStrings.size()
+				|| !IsInFile(entry.mOffset, entry.mSize))
+			{
+				return false;
+			}
+			scope.AddVariable(mStrings[entry.mNameId]).SetValue({ reinterpret_cast<const char*>(mFile.GetData() + entry.mOffset), entry.mSize });
+		}
+
+		std::vector<std::optional<Table>> tables(groupSections.size());
+		for (size_t i = 0; i < groupSections.size(); i++)
+		{
+			if (groupSections[i] >= mSections.size())
+			{
+				return false;
+			}
+
+			if (mSections[groupSections[i]].mType == SectionType::table)
+			{
+				tables[i] = ReadTable(groupSections[i]);
+				if (!tables[i].has_value())
+				{
+					return false;
+				}
+			}
+		}
+
+		// Reserved up front, so adding the children does not move them around.
+		scope.GetChildren().reserve(childEntries.size());
+		for (const ChildEntry& entry : childEntries)
+		{
+			if (entry.mGroup >= groupSections.size())
+			{
+				return false;
+			}
+
+			const SectionEntry& groupSection = mSections[groupSections[entry.mGroup]];
+			if (groupSection.mNameId >= mStrings.size())
+			{
+				return false;
+			}
+			Framework::Data::Scope& child = scope.AddChild(mStrings[groupSection.mNameId]);
+
+			if (tables[entry.mGroup].has_value())
+			{
+				uint32_t nodeIndex = 0;
+				if (entry.mIndexInGroup >= tables[entry.mGroup]->mSection.mNumOfRows
+					|| !ReadRow(tables[entry.mGroup].value(), entry.mIndexInGroup, nodeIndex, child, depth + 1))
+				{
+					return false;
+				}
+			}
+			else if (!ReadScope(groupSections[entry.mGroup], child, depth + 1))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	std::optional<Table> ReadTable(const uint32_t sectionIndex)
+	{
+		uint64_t offset = mSections[sectionIndex].mOffset;
+
+		Table table{};
+		if (!Read(offset, table.mSection))
+		{
+			return {};
+		}
+		offset = Align(offset + sizeof(TableSection));
+
+		table.mNodes.resize(table.mSection.mNumOfNodes);
+		table.mColumns.resize(table.mSection.mNumOfColumns);
+
+		if (!ReadArray(offset, table.mNodes))
+		{
+			return {};
+		}
+		offset = Align(offset + table.mNodes.size() * sizeof(ShapeNode));
+
+		if (!ReadArray(offset, table.mColumns))
+		{
+			return {};
+		}
+
+		for (const Column& column : table.mColumns)
+		{
+			if (column.mNameId >= mStrings.size()
+				|| !IsInFile(column.mOffset, static_cast<uint64_t>(column.mValueSize) * table.mSection.mNumOfRows))
+			{
+				return {};
+			}
+		}
+
+		for (const ShapeNode& node : table.mNodes)
+		{
+			if (node.mNameId >= mStrings.size()
+				|| static_cast<uint64_t>(node.mFirstColumn) + node.mNumOfVariables > table.mColumns.size())
+			{
+				return {};
+			}
+		}
+
+		return table;
+	}
+
+	// The name of the scope has already been set by whoever created it, only the variables and children are read.
+	bool ReadRow(const Table& table, const uint32_t row, uint32_t& nodeIndex, Framework::Data::Scope& scope, const uint32_t depth)
+	{
+		if (nodeIndex >= table.mNodes.size()
+			|| depth >= sMaxDepth)
+		{
+			return false;
+		}
+		const ShapeNode& node = table.mNodes[nodeIndex++];
+
+		scope.GetVariables().reserve(node.mNumOfVariables);
+		for (uint32_t i = 0; i < node.mNumOfVariables; i++)
+		{
+			const Column& column = table.mColumns[node.mFirstColumn + i];
+			const char* value = reinterpret_cast<const char*>(mFile.GetData() + column.mOffset) + static_cast<size_t>(column.mValueSize) * row;
+			scope.AddVariable(mStrings[column.mNameId]).SetValue({ value, column.mValueSize });
+		}
+
+		scope.GetChildren().reserve(node.mNumOfChildren);
+		for (uint32_t i = 0; i < node.mNumOfChildren; i++)
+		{
+			if (nodeIndex >= table.mNodes.size())
+			{
+				return false;
+			}
+
+			Framework::Data::Scope& child = scope.AddChild(mStrings[table.mNodes[nodeIndex].mNameId]);
+			if (!ReadRow(table, row, nodeIndex, child, depth + 1))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool IsInFile(const uint64_t offset, const uint64_t size) const
+	{
+		return offset <= mFile.GetSize()
+			&& size <= mFile.GetSize() - offset;
+	}
+
+	template<typename T>
+	bool Read(const uint64_t offset, T& out) const
+	{
+		if (!IsInFile(offset, sizeof(T)))
+		{
+			return false;
+		}
+		memcpy(&out, mFile.GetData() + offset, sizeof(T));
+		return true;
+	}
+
+	template<typename T>
+	bool ReadArray(const uint64_t offset, std::vector<T>& out) const
+	{
+		const uint64_t size = static_cast<uint64_t>(out.size()) * sizeof(T);
+		if (!IsInFile(offset, size))
+		{
+			return false;
+		}
+		if (size != 0)
+		{
+			memcpy(out.data(), mFile.GetData() + offset, static_cast<size_t>(size));
+		}
+		return true;
+	}
+
+	const Framework::MappedFile& mFile;
+	std::vector<SectionEntry> mSections{};
+	std::vector<bool> mIsSectionRead{};
+
+	// Interned once here, so the scopes and variables can share them.
+	std::vector<Framework::Data::InternedString> mStrings{};
+};
+
+bool Framework::Data::MappedSave::Save(const Scope& globalScope, const std::string& filePath)
+{
+	MappedSaveWriter writer{};
+	const uint32_t rootSection = writer.WriteScope(globalScope);
+	return writer.Finish(rootSection, filePath);
+}
+
+bool Framework::Data::MappedSave::Load(Scope& globalScope, const std::string& filePath)
+{
+	const MappedFile file(filePath);
+	if (!file.IsOpen())
+	{
+		return false;
+	}
+
+	MappedSaveReader reader(file);
+	if (!reader.Read(globalScope))
+	{
+		LOGWARNING(filePath << " is not a valid save, or was made with an older version");
+		globalScope.Clear();
+		return false;
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+namespace Framework::Data
+{
+	class Scope;
+
+	// A flat binary layout for saves, which is memory mapped when loading instead of being decoded bit by bit.
+	// Sibling scopes that have the exact same shape (e.g. every unit in a battle) are stored together as a table,
+	// where each variable is a column with the values of all those scopes back to back.
+	//
+	// File layout: Header | value data and sections | section index | string table
+	// Every section is either a single scope, or a table of same shaped scopes. All names are stored once in the string table.
+	class MappedSave
+	{
+	public:
+		// The scope has to be in the binary format. Returns false if the file could not be written.
+		static bool Save(const Scope& globalScope, const std::string& filePath);
+
+		// Returns false if the file does not exist or is not a valid save, the scope is left empty in that case.
+		static bool Load(Scope& globalScope, const std::string& filePath);
+
+		// Increase this whenever the layout changes, older saves will then no longer be loaded.
+		static constexpr uint32_t sVersion = 1;
+		static constexpr uint32_t sMagic = 0x56535452; // "RTSV"
+	};
+}
\ No newline at end of file
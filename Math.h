@@ -64,6 +64,27 @@ namespace Framework
 		static inline glm::vec3 ToGLM(const aiVector3D& v) { return { v.x, v.y, v.z }; }
 		static inline glm::quat ToGLM(const aiQuaternion& q) { return { q.w, q.x, q.y, q.z }; }
 
+		// FNV-1a, pass the result of a previous call as the hash to combine multiple pieces of data.
+		static constexpr uint64_t sEmptyHash = 14695981039346656037ull;
+		static inline uint64_t HashBytes(const void* data, const size_t numOfBytes, uint64_t hash = sEmptyHash)
+		{
+			const uchar* bytes = static_cast<const uchar*>(data);
+
+			for (size_t i = 0; i < numOfBytes; i++)
+			{
+				hash ^= bytes[i];
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		template<typename T>
+		static inline uint64_t Hash(const T& value, const uint64_t hash = sEmptyHash)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			return HashBytes(&value, sizeof(T), hash);
+		}
+
 		// https://www.gamedeveloper.com/business/how-to-work-with-bezier-curve-in-games-with-unity For more info
 		template<typename T>
 		static inline constexpr T BezierCurve(const T& p0, const T& p1, const T& p2, const float t)
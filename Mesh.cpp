@@ -44,14 +44,7 @@ void Framework::Mesh::SetVertices(std::vector<glm::vec3> vertices)
 {
 	mVertices = std::move(vertices);
 
-	glBindVertexArray(mVertexArrayObject);
-	glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
-
-	glBufferData(GL_ARRAY_BUFFER, mVertices.size() * sizeof(glm::vec3), &mVertices[0], GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-	glEnableVertexAttribArray(0);
-
-	glBindVertexArray(0);
+	UploadVertices(&mVertices[0], mVertices.size());
 
 	UpdateRadius();
 }
@@ -60,38 +53,60 @@ void Framework::Mesh::SetNormals(std::vector<glm::vec3> normals)
 {
 	mNormals = std::move(normals);
 
+	UploadNormals(&mNormals[0], mNormals.size());
+}
+
+void Framework::Mesh::SetUVs(std::vector<glm::vec2> UVs)
+{
+	mUVs = std::move(UVs);
+
+	UploadUVs(&mUVs[0], mUVs.size());
+}
+
+void Framework::Mesh::SetTriangles(std::vector<Triangle> triangles)
+{
+	mTriangles = std::move(triangles);
+
 	glBindVertexArray(mVertexArrayObject);
-	glBindBuffer(GL_ARRAY_BUFFER, mNormalBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mTrianglesBuffer);
 
-	glBufferData(GL_ARRAY_BUFFER, mNormals.size() * sizeof(glm::vec3), &mNormals[0], GL_STATIC_DRAW);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-	glEnableVertexAttribArray(1);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, mTriangles.size() * sizeof(Triangle), &mTriangles[0], GL_STATIC_DRAW);
 
 	glBindVertexArray(0);
 }
 
-void Framework::Mesh::SetUVs(std::vector<glm::vec2> UVs)
+void Framework::Mesh::UploadVertices(const glm::vec3* vertices, const size_t numOfVertices)
 {
-	mUVs = std::move(UVs);
-
 	glBindVertexArray(mVertexArrayObject);
-	glBindBuffer(GL_ARRAY_BUFFER, mUVBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
 
-	glBufferData(GL_ARRAY_BUFFER, mUVs.size() * sizeof(glm::vec2), &mUVs[0], GL_STATIC_DRAW);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
-	glEnableVertexAttribArray(2);
+	glBufferData(GL_ARRAY_BUFFER, numOfVertices * sizeof(glm::vec3), vertices, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+	glEnableVertexAttribArray(0);
 
 	glBindVertexArray(0);
 }
 
-void Framework::Mesh::SetTriangles(std::vector<Triangle> triangles)
+void Framework::Mesh::UploadNormals(const glm::vec3* normals, const size_t numOfNormals)
 {
-	mTriangles = std::move(triangles);
+	glBindVertexArray(mVertexArrayObject);
+	glBindBuffer(GL_ARRAY_BUFFER, mNormalBuffer);
 
+	glBufferData(GL_ARRAY_BUFFER, numOfNormals * sizeof(glm::vec3), normals, GL_STATIC_DRAW);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+	glEnableVertexAttribArray(1);
+
+	glBindVertexArray(0);
+}
+
+void Framework::Mesh::UploadUVs(const glm::vec2* UVs, const size_t numOfUVs)
+{
 	glBindVertexArray(mVertexArrayObject);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mTrianglesBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, mUVBuffer);
 
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, mTriangles.size() * sizeof(Triangle), &mTriangles[0], GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, numOfUVs * sizeof(glm::vec2), UVs, GL_STATIC_DRAW);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+	glEnableVertexAttribArray(2);
 
 	glBindVertexArray(0);
 }
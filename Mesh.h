@@ -14,6 +14,7 @@ namespace Framework
 		virtual ~Mesh();
 
 		inline size_t GetNumOfVertices() const { return mVertices.size(); }
+		inline size_t GetNumOfTriangles() const { return mTriangles.size(); }
 		inline GLuint GetVertexArrayObject() const { return mVertexArrayObject; }
 		inline const float GetRadius() const { return mRadius; }
 		inline MeshId GetMeshId() const { return mMeshId; }
@@ -34,6 +35,12 @@ namespace Framework
 		void SetUVs(std::vector<glm::vec2> UVs);
 		void SetTriangles(std::vector<Triangle> triangles);
 
+		// Sends the data to the GPU without keeping a copy on the CPU, for when the data is owned by someone else.
+		// Does not update the radius or the number of vertices.
+		void UploadVertices(const glm::vec3* vertices, const size_t numOfVertices);
+		void UploadNormals(const glm::vec3* normals, const size_t numOfNormals);
+		void UploadUVs(const glm::vec2* UVs, const size_t numOfUVs);
+
 		void SetMaterial(const std::shared_ptr<Material>& material);
 		void SetShader(const std::shared_ptr<MyShader>& shader);
 		
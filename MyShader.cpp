@@ -93,9 +93,14 @@ void Framework::MyShader::Unbind() const
 }
 
 void Framework::MyShader::SetInputTexture(const uint slot, const char* name, const Texture& texture) const
+{
+	SetInputTexture(slot, name, texture.GetId());
+}
+
+void Framework::MyShader::SetInputTexture(const uint slot, const char* name, const GLuint textureId) const
 {
 	glActiveTexture(GL_TEXTURE0 + slot);
-	glBindTexture(GL_TEXTURE_2D, texture.GetId());
+	glBindTexture(GL_TEXTURE_2D, textureId);
 	glUniform1i(glGetUniformLocation(mId, name), slot);
 	CheckGL();
 }
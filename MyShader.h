@@ -15,6 +15,7 @@ namespace Framework
 		void Unbind() const;
 		
 		void SetInputTexture(const uint slot, const char* name, const Texture& texture) const;
+		void SetInputTexture(const uint slot, const char* name, const GLuint textureId) const;
 		void SetInputMatrix(const char* name, const glm::mat4& matrix) const;
 		void SetFloat(const char* name, const float v) const;
 		void SetInt(const char* name, const int v) const;
@@ -0,0 +1,72 @@
+#pragma once
+
+namespace Framework
+{
+	// Hands out memory for objects of one type from slabs, reusing the slots of the objects that were freed. Allocating and freeing are
+	// O(1), and objects of the same type end up close to each other. The slabs are kept until the game exits. Only use it from the main thread.
+	template<typename T>
+	class ObjectPool
+	{
+	public:
+		// Types derived from T that do not have a pool of their own are a different size, those are allocated from the heap instead.
+		static void* Allocate(const size_t size);
+		static void Free(void* ptr, const size_t size);
+
+		static inline size_t GetNumOfObjects() { return sNumOfObjects; }
+		static inline size_t GetNumOfSlots() { return sSlabs.size() * sNumOfSlotsPerSlab; }
+
+	private:
+		union Slot
+		{
+			Slot* mNextFree;
+			alignas(T) std::byte mStorage[sizeof(T)];
+		};
+
+		static constexpr size_t sNumOfSlotsPerSlab = std::max<size_t>(16384 / sizeof(Slot), 16);
+
+		static inline std::vector<std::unique_ptr<Slot[]>> sSlabs{};
+		static inline Slot* sFirstFree{};
+		static inline size_t sNumOfObjects{};
+	};
+
+	template<typename T>
+	void* ObjectPool<T>::Allocate(const size_t size)
+	{
+		if (size != sizeof(T))
+		{
+			return ::operator new(size);
+		}
+
+		if (sFirstFree == nullptr)
+		{
+			Slot* slab = sSlabs.emplace_back(std::unique_ptr<Slot[]>(new Slot[sNumOfSlotsPerSlab])).get();
+
+			for (size_t i = 0; i < sNumOfSlotsPerSlab; i++)
+			{
+				slab[i].mNextFree = i + 1 < sNumOfSlotsPerSlab ? &slab[i + 1] : nullptr;
+			}
+			sFirstFree = slab;
+		}
+
+		Slot* slot = sFirstFree;
+		sFirstFree = slot->mNextFree;
+		++sNumOfObjects;
+
+		return slot->mStorage;
+	}
+
+	template<typename T>
+	void ObjectPool<T>::Free(void* ptr, const size_t size)
+	{
+		if (size != sizeof(T))
+		{
+			::operator delete(ptr);
+			return;
+		}
+
+		Slot* slot = reinterpret_cast<Slot*>(ptr);
+		slot->mNextFree = sFirstFree;
+		sFirstFree = slot;
+		--sNumOfObjects;
+	}
+}
\ No newline at end of file
@@ -19,16 +19,23 @@ RTS::Opponent::Opponent(Framework::Scene& scene, Framework::EntityId armyEntityI
 
 void RTS::Opponent::FixedTick()
 {
+	// When watching a replay, the opponent gives the orders it gave during the recording at the same moment instead.
+	if (Replay* replay = Replay::TryGet(mScene); replay != nullptr
+		&& !replay->IsRecording())
+	{
+		replay->IssueOrders(OrderIssuer::opponent, mScene);
+		return;
+	}
+
 	std::vector<Unit*> units = mArmy->GetUnitsInArmy();
+	OrderAggroLevel(OrderIssuer::opponent, units, AggroLevel::pursuit);
 
 	std::vector<Unit*> unitsToCommand;
 	unitsToCommand.reserve(units.size());
 
 	for (Unit* unit : units)
 	{
-		unit->SetAggroLevel(AggroLevel::pursuit);
-
-		if (Framework::Random::Range(1.0f) <= sGiveCommandChance)
+		if (Framework::Random::Range(1.0f, mRandomSeed) <= sGiveCommandChance)
 		{
 			unitsToCommand.push_back(unit);
 		}
@@ -68,22 +75,18 @@ void RTS::Opponent::Deserialize(const Framework::Data::Scope& parentScope)
 
 	Framework::EntityId id;
 	myScope.GetVariable("armyEntityId") >> id;
-	mScene.mEntityManager->DelayedIdRequest(id,
-		[](Entity& entity, void* me)
-		{
-			static_cast<Opponent*>(me)->SetArmy(static_cast<Army*>(&entity));
-		}, this);
+	mScene.mEntityManager->ResolveOnceLoaded(id, mArmy);
 }
 
-void RTS::Opponent::OrderToRandomPosition(std::vector<Unit*>&& group) const
+void RTS::Opponent::OrderToRandomPosition(std::vector<Unit*>&& group)
 {
 	const Framework::TerrainData* const terrainData = mScene.mTerrain->GetData();
-	glm::vec2 position = { Framework::Random::Range(sMinDistFromEdge, terrainData->mWorldSizeX - sMinDistFromEdge), Framework::Random::Range(sMinDistFromEdge, terrainData->mWorldSizeZ - sMinDistFromEdge) };
+	glm::vec2 position = { Framework::Random::Range(sMinDistFromEdge, terrainData->mWorldSizeX - sMinDistFromEdge, mRandomSeed), Framework::Random::Range(sMinDistFromEdge, terrainData->mWorldSizeZ - sMinDistFromEdge, mRandomSeed) };
 
-	FormFormation(std::move(group), position);
+	OrderFormation(OrderIssuer::opponent, std::move(group), position);
 }
 
-uint RTS::Opponent::RandomGroupSize() const
+uint RTS::Opponent::RandomGroupSize()
 {
-	return Framework::Random::Uint() % (sMaxGroupSize - sMinGroupSize) + sMinGroupSize;
+	return Framework::Random::Uint(mRandomSeed) % (sMaxGroupSize - sMinGroupSize) + sMinGroupSize;
 }
\ No newline at end of file
@@ -17,12 +17,13 @@ namespace RTS
 
 		bool Serialize(Framework::Data::Scope& parentScope) const;
 		void Deserialize(const Framework::Data::Scope& parentScope);
+		inline bool HasStateBesidesTransform() const { return true; }
 
 		inline void SetArmy(Army* army) { mArmy = army; }
 
 	private:
-		void OrderToRandomPosition(std::vector<Unit*>&& group) const;
-		uint RandomGroupSize() const;
+		void OrderToRandomPosition(std::vector<Unit*>&& group);
+		uint RandomGroupSize();
 
 		Army* mArmy{};
 
@@ -82,6 +82,19 @@
 # endif
 
 
+// SIMD instruction set used by the batched octave kernels, the scalar code is used when none are available
+#if defined(__AVX2__)
+#	include <immintrin.h>
+#	define SIVPERLIN_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#	include <emmintrin.h>
+#	define SIVPERLIN_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#	include <arm_neon.h>
+#	define SIVPERLIN_SIMD_NEON
+#endif
+
+
 namespace siv
 {
 	template <class Float>
@@ -209,6 +222,15 @@ namespace siv
 		[[nodiscard]]
 		value_type octave3D_01(value_type x, value_type y, value_type z, std::int32_t octaves, value_type persistence = value_type(0.5)) const noexcept;
 
+		///////////////////////////////////////
+		//
+		//	Batched octave noise (The result is clamped and remapped to the range [0, 1])
+		//	out[i] = octave2D_01(static_cast<value_type>(i) * xScale, y, octaves, persistence) for every i in [0, count)
+		//	8 (AVX2) or 4 (SSE2/NEON) samples are evaluated at once when value_type is float.
+		//
+
+		void octave2DRow_01(value_type* out, std::size_t count, value_type xScale, value_type y, std::int32_t octaves, value_type persistence = value_type(0.5)) const noexcept;
+
 		///////////////////////////////////////
 		//
 		//	Octave noise (The result is normalized to the range [-1, 1])
@@ -404,6 +426,271 @@ namespace siv
 
 			return result;
 		}
+
+#if defined(SIVPERLIN_SIMD_AVX2) || defined(SIVPERLIN_SIMD_SSE2) || defined(SIVPERLIN_SIMD_NEON)
+		////////////////////////////////////////////////
+		//
+		//	Lane-wise versions of the scalar functions above.
+		//	Every operation is performed in the same order as the scalar code, so the results match the scalar octave2D_01.
+		//
+#	if defined(SIVPERLIN_SIMD_AVX2)
+		struct SimdFloat
+		{
+			static constexpr std::size_t Width = 8;
+			using vf = __m256;
+			using vi = __m256i;
+
+			static vf Set(const float v) noexcept { return _mm256_set1_ps(v); }
+			static vi SetI(const std::int32_t v) noexcept { return _mm256_set1_epi32(v); }
+			static vi LaneIndices(const std::int32_t first) noexcept { return _mm256_add_epi32(_mm256_set1_epi32(first), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)); }
+			static void Store(float* out, const vf v) noexcept { _mm256_storeu_ps(out, v); }
+
+			static vf Add(const vf a, const vf b) noexcept { return _mm256_add_ps(a, b); }
+			static vf Sub(const vf a, const vf b) noexcept { return _mm256_sub_ps(a, b); }
+			static vf Mul(const vf a, const vf b) noexcept { return _mm256_mul_ps(a, b); }
+			static vf And(const vf a, const vf b) noexcept { return _mm256_and_ps(a, b); }
+			static vf Or(const vf a, const vf b) noexcept { return _mm256_or_ps(a, b); }
+			static vf Xor(const vf a, const vf b) noexcept { return _mm256_xor_ps(a, b); }
+			static vf LessThan(const vf a, const vf b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+			static vf LessEqual(const vf a, const vf b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+			static vf Select(const vf mask, const vf ifTrue, const vf ifFalse) noexcept { return _mm256_blendv_ps(ifFalse, ifTrue, mask); }
+
+			static vi AddI(const vi a, const vi b) noexcept { return _mm256_add_epi32(a, b); }
+			static vi AndI(const vi a, const vi b) noexcept { return _mm256_and_si256(a, b); }
+			static vf LessThanI(const vi a, const vi b) noexcept { return _mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a)); }
+			static vf EqualI(const vi a, const vi b) noexcept { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)); }
+			template <int Shift>
+			static vf ShiftLeftAsFloat(const vi a) noexcept { return _mm256_castsi256_ps(_mm256_slli_epi32(a, Shift)); }
+
+			static vi Truncate(const vf a) noexcept { return _mm256_cvttps_epi32(a); }
+			static vf ToFloat(const vi a) noexcept { return _mm256_cvtepi32_ps(a); }
+
+			static vi Lookup(const std::int32_t* table, const vi index) noexcept { return _mm256_i32gather_epi32(table, index, 4); }
+		};
+#	elif defined(SIVPERLIN_SIMD_SSE2)
+		struct SimdFloat
+		{
+			static constexpr std::size_t Width = 4;
+			using vf = __m128;
+			using vi = __m128i;
+
+			static vf Set(const float v) noexcept { return _mm_set1_ps(v); }
+			static vi SetI(const std::int32_t v) noexcept { return _mm_set1_epi32(v); }
+			static vi LaneIndices(const std::int32_t first) noexcept { return _mm_add_epi32(_mm_set1_epi32(first), _mm_setr_epi32(0, 1, 2, 3)); }
+			static void Store(float* out, const vf v) noexcept { _mm_storeu_ps(out, v); }
+
+			static vf Add(const vf a, const vf b) noexcept { return _mm_add_ps(a, b); }
+			static vf Sub(const vf a, const vf b) noexcept { return _mm_sub_ps(a, b); }
+			static vf Mul(const vf a, const vf b) noexcept { return _mm_mul_ps(a, b); }
+			static vf And(const vf a, const vf b) noexcept { return _mm_and_ps(a, b); }
+			static vf Or(const vf a, const vf b) noexcept { return _mm_or_ps(a, b); }
+			static vf Xor(const vf a, const vf b) noexcept { return _mm_xor_ps(a, b); }
+			static vf LessThan(const vf a, const vf b) noexcept { return _mm_cmplt_ps(a, b); }
+			static vf LessEqual(const vf a, const vf b) noexcept { return _mm_cmple_ps(a, b); }
+			static vf Select(const vf mask, const vf ifTrue, const vf ifFalse) noexcept { return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse)); }
+
+			static vi AddI(const vi a, const vi b) noexcept { return _mm_add_epi32(a, b); }
+			static vi AndI(const vi a, const vi b) noexcept { return _mm_and_si128(a, b); }
+			static vf LessThanI(const vi a, const vi b) noexcept { return _mm_castsi128_ps(_mm_cmplt_epi32(a, b)); }
+			static vf EqualI(const vi a, const vi b) noexcept { return _mm_castsi128_ps(_mm_cmpeq_epi32(a, b)); }
+			template <int Shift>
+			static vf ShiftLeftAsFloat(const vi a) noexcept { return _mm_castsi128_ps(_mm_slli_epi32(a, Shift)); }
+
+			static vi Truncate(const vf a) noexcept { return _mm_cvttps_epi32(a); }
+			static vf ToFloat(const vi a) noexcept { return _mm_cvtepi32_ps(a); }
+
+			// SSE2 has no gather, the lanes are looked up one by one.
+			static vi Lookup(const std::int32_t* table, const vi index) noexcept
+			{
+				alignas(16) std::int32_t lanes[Width];
+				_mm_store_si128(reinterpret_cast<__m128i*>(lanes), index);
+				return _mm_setr_epi32(table[lanes[0]], table[lanes[1]], table[lanes[2]], table[lanes[3]]);
+			}
+		};
+#	elif defined(SIVPERLIN_SIMD_NEON)
+		struct SimdFloat
+		{
+			static constexpr std::size_t Width = 4;
+			using vf = float32x4_t;
+			using vi = int32x4_t;
+
+			static vf Set(const float v) noexcept { return vdupq_n_f32(v); }
+			static vi SetI(const std::int32_t v) noexcept { return vdupq_n_s32(v); }
+			static vi LaneIndices(const std::int32_t first) noexcept
+			{
+				alignas(16) const std::int32_t offsets[Width]{ 0, 1, 2, 3 };
+				return vaddq_s32(vdupq_n_s32(first), vld1q_s32(offsets));
+			}
+			static void Store(float* out, const vf v) noexcept { vst1q_f32(out, v); }
+
+			static vf Add(const vf a, const vf b) noexcept { return vaddq_f32(a, b); }
+			static vf Sub(const vf a, const vf b) noexcept { return vsubq_f32(a, b); }
+			static vf Mul(const vf a, const vf b) noexcept { return vmulq_f32(a, b); }
+			static vf And(const vf a, const vf b) noexcept { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+			static vf Or(const vf a, const vf b) noexcept { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+			static vf Xor(const vf a, const vf b) noexcept { return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+			static vf LessThan(const vf a, const vf b) noexcept { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+			static vf LessEqual(const vf a, const vf b) noexcept { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+			static vf Select(const vf mask, const vf ifTrue, const vf ifFalse) noexcept { return vbslq_f32(vreinterpretq_u32_f32(mask), ifTrue, ifFalse); }
+
+			static vi AddI(const vi a, const vi b) noexcept { return vaddq_s32(a, b); }
+			static vi AndI(const vi a, const vi b) noexcept { return vandq_s32(a, b); }
+			static vf LessThanI(const vi a, const vi b) noexcept { return vreinterpretq_f32_u32(vcltq_s32(a, b)); }
+			static vf EqualI(const vi a, const vi b) noexcept { return vreinterpretq_f32_u32(vceqq_s32(a, b)); }
+			template <int Shift>
+			static vf ShiftLeftAsFloat(const vi a) noexcept { return vreinterpretq_f32_s32(vshlq_n_s32(a, Shift)); }
+
+			static vi Truncate(const vf a) noexcept { return vcvtq_s32_f32(a); }
+			static vf ToFloat(const vi a) noexcept { return vcvtq_f32_s32(a); }
+
+			// NEON has no gather, the lanes are looked up one by one.
+			static vi Lookup(const std::int32_t* table, const vi index) noexcept
+			{
+				alignas(16) std::int32_t lanes[Width];
+				vst1q_s32(lanes, index);
+				for (std::int32_t& lane : lanes)
+				{
+					lane = table[lane];
+				}
+				return vld1q_s32(lanes);
+			}
+		};
+#	endif
+
+		template <class Simd>
+		[[nodiscard]]
+		inline typename Simd::vf SimdFloor(const typename Simd::vf x) noexcept
+		{
+			// Only valid within the range of an int32, which is always the case for the coordinates we sample.
+			const typename Simd::vf truncated = Simd::ToFloat(Simd::Truncate(x));
+			return Simd::Sub(truncated, Simd::And(Simd::LessThan(x, truncated), Simd::Set(1.0f)));
+		}
+
+		template <class Simd>
+		[[nodiscard]]
+		inline typename Simd::vf SimdFade(const typename Simd::vf t) noexcept
+		{
+			const typename Simd::vf inner = Simd::Add(Simd::Mul(t, Simd::Sub(Simd::Mul(t, Simd::Set(6.0f)), Simd::Set(15.0f))), Simd::Set(10.0f));
+			return Simd::Mul(Simd::Mul(Simd::Mul(t, t), t), inner);
+		}
+
+		template <class Simd>
+		[[nodiscard]]
+		inline typename Simd::vf SimdLerp(const typename Simd::vf a, const typename Simd::vf b, const typename Simd::vf t) noexcept
+		{
+			return Simd::Add(a, Simd::Mul(Simd::Sub(b, a), t));
+		}
+
+		template <class Simd>
+		[[nodiscard]]
+		inline typename Simd::vf SimdGrad(const typename Simd::vi hash, const typename Simd::vf x, const typename Simd::vf y, const typename Simd::vf z) noexcept
+		{
+			const typename Simd::vi h = Simd::AndI(hash, Simd::SetI(15));
+			const typename Simd::vf u = Simd::Select(Simd::LessThanI(h, Simd::SetI(8)), x, y);
+			const typename Simd::vf xOrZ = Simd::Select(Simd::Or(Simd::EqualI(h, Simd::SetI(12)), Simd::EqualI(h, Simd::SetI(14))), x, z);
+			const typename Simd::vf v = Simd::Select(Simd::LessThanI(h, Simd::SetI(4)), y, xOrZ);
+
+			// Negating is the same as flipping the sign bit, bit 0 and bit 1 of the hash are moved into the sign bit.
+			const typename Simd::vf uSign = Simd::template ShiftLeftAsFloat<31>(Simd::AndI(h, Simd::SetI(1)));
+			const typename Simd::vf vSign = Simd::template ShiftLeftAsFloat<30>(Simd::AndI(h, Simd::SetI(2)));
+			return Simd::Add(Simd::Xor(u, uSign), Simd::Xor(v, vSign));
+		}
+
+		template <class Simd>
+		[[nodiscard]]
+		inline typename Simd::vf SimdNoise2D(const std::int32_t* permutation, const typename Simd::vf x, const typename Simd::vf y) noexcept
+		{
+			using vf = typename Simd::vf;
+			using vi = typename Simd::vi;
+
+			// z is the same for every lane, so it is done using the scalar functions.
+			const float z = static_cast<float>(SIVPERLIN_DEFAULT_Z);
+			const float _z = std::floor(z);
+			const vi iz = Simd::SetI(static_cast<std::int32_t>(_z) & 255);
+			const vf fz = Simd::Set(z - _z);
+			const vf fzMinusOne = Simd::Set((z - _z) - 1);
+			const vf w = Simd::Set(Fade(z - _z));
+
+			const vf _x = SimdFloor<Simd>(x);
+			const vf _y = SimdFloor<Simd>(y);
+
+			const vi mask = Simd::SetI(255);
+			const vi one = Simd::SetI(1);
+			const vi ix = Simd::AndI(Simd::Truncate(_x), mask);
+			const vi iy = Simd::AndI(Simd::Truncate(_y), mask);
+
+			const vf fx = Simd::Sub(x, _x);
+			const vf fy = Simd::Sub(y, _y);
+			const vf fxMinusOne = Simd::Sub(fx, Simd::Set(1.0f));
+			const vf fyMinusOne = Simd::Sub(fy, Simd::Set(1.0f));
+
+			const vf u = SimdFade<Simd>(fx);
+			const vf v = SimdFade<Simd>(fy);
+
+			const vi A = Simd::AndI(Simd::AddI(Simd::Lookup(permutation, ix), iy), mask);
+			const vi B = Simd::AndI(Simd::AddI(Simd::Lookup(permutation, Simd::AndI(Simd::AddI(ix, one), mask)), iy), mask);
+
+			const vi AA = Simd::AndI(Simd::AddI(Simd::Lookup(permutation, A), iz), mask);
+			const vi AB = Simd::AndI(Simd::AddI(Simd::Lookup(permutation, Simd::AndI(Simd::AddI(A, one), mask)), iz), mask);
+
+			const vi BA = Simd::AndI(Simd::AddI(Simd::Lookup(permutation, B), iz), mask);
+			const vi BB = Simd::AndI(Simd::AddI(Simd::Lookup(permutation, Simd::AndI(Simd::AddI(B, one), mask)), iz), mask);
+
+			const vf p0 = SimdGrad<Simd>(Simd::Lookup(permutation, AA), fx, fy, fz);
+			const vf p1 = SimdGrad<Simd>(Simd::Lookup(permutation, BA), fxMinusOne, fy, fz);
+			const vf p2 = SimdGrad<Simd>(Simd::Lookup(permutation, AB), fx, fyMinusOne, fz);
+			const vf p3 = SimdGrad<Simd>(Simd::Lookup(permutation, BB), fxMinusOne, fyMinusOne, fz);
+			const vf p4 = SimdGrad<Simd>(Simd::Lookup(permutation, Simd::AndI(Simd::AddI(AA, one), mask)), fx, fy, fzMinusOne);
+			const vf p5 = SimdGrad<Simd>(Simd::Lookup(permutation, Simd::AndI(Simd::AddI(BA, one), mask)), fxMinusOne, fy, fzMinusOne);
+			const vf p6 = SimdGrad<Simd>(Simd::Lookup(permutation, Simd::AndI(Simd::AddI(AB, one), mask)), fx, fyMinusOne, fzMinusOne);
+			const vf p7 = SimdGrad<Simd>(Simd::Lookup(permutation, Simd::AndI(Simd::AddI(BB, one), mask)), fxMinusOne, fyMinusOne, fzMinusOne);
+
+			const vf q0 = SimdLerp<Simd>(p0, p1, u);
+			const vf q1 = SimdLerp<Simd>(p2, p3, u);
+			const vf q2 = SimdLerp<Simd>(p4, p5, u);
+			const vf q3 = SimdLerp<Simd>(p6, p7, u);
+
+			const vf r0 = SimdLerp<Simd>(q0, q1, v);
+			const vf r1 = SimdLerp<Simd>(q2, q3, v);
+
+			return SimdLerp<Simd>(r0, r1, w);
+		}
+
+		// Fills out[0, count) rounded down to a multiple of the lane width, returns the number of samples written.
+		template <class Simd>
+		inline std::size_t SimdOctave2DRow_01(const std::int32_t* permutation, float* out, const std::size_t count, const float xScale, const float y, const std::int32_t octaves, const float persistence) noexcept
+		{
+			using vf = typename Simd::vf;
+
+			const std::size_t numOfBatched = count - (count % Simd::Width);
+
+			for (std::size_t i = 0; i < numOfBatched; i += Simd::Width)
+			{
+				vf x = Simd::Mul(Simd::ToFloat(Simd::LaneIndices(static_cast<std::int32_t>(i))), Simd::Set(xScale));
+				vf yy = Simd::Set(y);
+				vf result = Simd::Set(0.0f);
+				float amplitude = 1;
+
+				for (std::int32_t octave = 0; octave < octaves; ++octave)
+				{
+					result = Simd::Add(result, Simd::Mul(SimdNoise2D<Simd>(permutation, x, yy), Simd::Set(amplitude)));
+					x = Simd::Mul(x, Simd::Set(2.0f));
+					yy = Simd::Mul(yy, Simd::Set(2.0f));
+					amplitude *= persistence;
+				}
+
+				// RemapClamp_01
+				vf remapped = Simd::Add(Simd::Mul(result, Simd::Set(0.5f)), Simd::Set(0.5f));
+				remapped = Simd::Select(Simd::LessEqual(result, Simd::Set(-1.0f)), Simd::Set(0.0f), remapped);
+				remapped = Simd::Select(Simd::LessEqual(Simd::Set(1.0f), result), Simd::Set(1.0f), remapped);
+				Simd::Store(out + i, remapped);
+			}
+
+			return numOfBatched;
+		}
+		//
+		////////////////////////////////////////////////
+#endif
 	}
 
 	///////////////////////////////////////
@@ -614,6 +901,28 @@ namespace siv
 		return perlin_detail::RemapClamp_01(octave3D(x, y, z, octaves, persistence));
 	}
 
+	template <class Float>
+	inline void BasicPerlinNoise<Float>::octave2DRow_01(value_type* out, const std::size_t count, const value_type xScale, const value_type y, const std::int32_t octaves, const value_type persistence) const noexcept
+	{
+		std::size_t i = 0;
+
+#if defined(SIVPERLIN_SIMD_AVX2) || defined(SIVPERLIN_SIMD_SSE2) || defined(SIVPERLIN_SIMD_NEON)
+		if constexpr (std::is_same_v<Float, float>)
+		{
+			// Widened so that AVX2 can gather from it directly.
+			alignas(32) std::int32_t permutation[256];
+			std::copy(m_permutation.begin(), m_permutation.end(), permutation);
+
+			i = perlin_detail::SimdOctave2DRow_01<perlin_detail::SimdFloat>(permutation, out, count, xScale, y, octaves, persistence);
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			out[i] = octave2D_01(static_cast<value_type>(i) * xScale, y, octaves, persistence);
+		}
+	}
+
 	///////////////////////////////////////
 
 	template <class Float>
@@ -657,4 +966,7 @@ namespace siv
 
 # undef SIVPERLIN_NODISCARD_CXX20
 # undef SIVPERLIN_CONCEPT_URBG
-# undef SIVPERLIN_CONCEPT_URBG_
\ No newline at end of file
+# undef SIVPERLIN_CONCEPT_URBG_
+# undef SIVPERLIN_SIMD_AVX2
+# undef SIVPERLIN_SIMD_SSE2
+# undef SIVPERLIN_SIMD_NEON
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include "precomp.h"
 #include "Physics.h"
 
+#include <bullet/BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <bullet/BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <bullet/LinearMath/btThreads.h>
+
 #include "Entity.h"
 #include "Scene.h"
 #include "Camera.h"
@@ -8,16 +12,117 @@
 #include "Transform.h"
 #include "TimeManager.h"
 #include "Terrain.h"
+#include "Profiler.h"
+#include "Settings.h"
+#include "Scope.h"
+#include "JobSystem.h"
+
+namespace Framework
+{
+	// Lets bullet's multithreaded world use the workers of the job system, instead of starting threads of its own.
+	class JobSystemTaskScheduler :
+		public btITaskScheduler
+	{
+	public:
+		JobSystemTaskScheduler() : btITaskScheduler("JobSystem") {}
+
+		int getMaxNumThreads() const override { return std::min(static_cast<int>(JobSystem::Inst().GetNumOfThreads()), static_cast<int>(BT_MAX_THREAD_COUNT)); }
+		int getNumThreads() const override { return getMaxNumThreads(); }
+
+		// The job system always uses all of its workers.
+		void setNumThreads(int) override {}
+
+		void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override;
+		btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override;
+	};
+}
+
+void Framework::JobSystemTaskScheduler::parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body)
+{
+	if (iEnd <= iBegin)
+	{
+		return;
+	}
+
+	grainSize = std::max(grainSize, 1);
+	const int numOfChunks = (iEnd - iBegin + grainSize - 1) / grainSize;
+
+	JobSystem::Inst().ParallelFor(static_cast<size_t>(numOfChunks),
+		[iBegin, iEnd, grainSize, &body](const size_t chunk)
+		{
+			const int chunkBegin = iBegin + static_cast<int>(chunk) * grainSize;
+			body.forLoop(chunkBegin, std::min(chunkBegin + grainSize, iEnd));
+		});
+}
+
+btScalar Framework::JobSystemTaskScheduler::parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body)
+{
+	if (iEnd <= iBegin)
+	{
+		return btScalar(0.0);
+	}
+
+	grainSize = std::max(grainSize, 1);
+	const int numOfChunks = (iEnd - iBegin + grainSize - 1) / grainSize;
+
+	// Each chunk writes its own sum, they are added up in order afterwards so that the result does not depend on which thread finished first.
+	std::vector<btScalar> sums(static_cast<size_t>(numOfChunks));
+
+	JobSystem::Inst().ParallelFor(static_cast<size_t>(numOfChunks),
+		[iBegin, iEnd, grainSize, &body, &sums](const size_t chunk)
+		{
+			const int chunkBegin = iBegin + static_cast<int>(chunk) * grainSize;
+			sums[chunk] = body.sumLoop(chunkBegin, std::min(chunkBegin + grainSize, iEnd));
+		});
+
+	btScalar sum{};
+
+	for (const btScalar chunkSum : sums)
+	{
+		sum += chunkSum;
+	}
+	return sum;
+}
 
 Framework::Physics::Physics(Scene& scene) :
 	mScene(scene),
 	mDebugDrawer(scene)
 {
+#if BT_THREADSAFE
+	Settings::Inst().GetSettings().GetVariable("multithreadedPhysics") >> mIsMultithreaded;
+
+	// Bullet does not promise the same results between runs when multithreaded, which replays and the state hashes depend on.
+	mIsMultithreaded = mIsMultithreaded && !mScene.IsDeterministic();
+#endif // BT_THREADSAFE
+
 	mBroadPhase = new btDbvtBroadphase;
-	mCollisionConfiguration = new btDefaultCollisionConfiguration;
-	mDispatcher = new btCollisionDispatcher(mCollisionConfiguration);
-	mConstraintSolver = new btSequentialImpulseConstraintSolver;
-	mWorld = new btDiscreteDynamicsWorld(mDispatcher, mBroadPhase, mConstraintSolver, mCollisionConfiguration);
+
+	if (mIsMultithreaded)
+	{
+		// Has to be set before any of bullet's multithreaded classes are constructed.
+		static JobSystemTaskScheduler taskScheduler{};
+		btSetTaskScheduler(&taskScheduler);
+
+		// Large enough that the workers rarely run out of pooled manifolds and algorithms, the same sizes as bullet's own multithreaded demo.
+		btDefaultCollisionConstructionInfo constructionInfo{};
+		constructionInfo.m_defaultMaxPersistentManifoldPoolSize = 80000;
+		constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize = 80000;
+
+		mCollisionConfiguration = new btDefaultCollisionConfiguration(constructionInfo);
+		mDispatcher = new btCollisionDispatcherMt(mCollisionConfiguration);
+
+		// One solver for each thread, so that every thread can solve an island of its own at the same time.
+		btConstraintSolverPoolMt* solverPool = new btConstraintSolverPoolMt(taskScheduler.getNumThreads());
+		mConstraintSolver = solverPool;
+		mWorld = new btDiscreteDynamicsWorldMt(mDispatcher, mBroadPhase, solverPool, nullptr, mCollisionConfiguration);
+	}
+	else
+	{
+		mCollisionConfiguration = new btDefaultCollisionConfiguration;
+		mDispatcher = new btCollisionDispatcher(mCollisionConfiguration);
+		mConstraintSolver = new btSequentialImpulseConstraintSolver;
+		mWorld = new btDiscreteDynamicsWorld(mDispatcher, mBroadPhase, mConstraintSolver, mCollisionConfiguration);
+	}
 	
 	mWorld->setDebugDrawer(&mDebugDrawer);
 	mWorld->setGravity({ 0.0f, -9.81f, 0.0f });
@@ -36,7 +141,30 @@ Framework::Physics::~Physics()
 
 void Framework::Physics::Tick()
 {
-	mWorld->stepSimulation(TimeManager::GetDeltaTime());
+	PROFILE_ZONE("Physics::Tick");
+
+	CopyTransformsToBullet();
+
+	if (mScene.IsDeterministic())
+	{
+		// Takes exactly one step of the fixed delta time, instead of interpolating between bullet's own fixed steps.
+		mWorld->stepSimulation(TimeManager::GetDeltaTime(), 0);
+		mTimeSinceLastFixedStep = 0.0f;
+	}
+	else
+	{
+		mWorld->stepSimulation(TimeManager::GetDeltaTime(), 1, sFixedTimeStep);
+
+		// The same calculation as in btDiscreteDynamicsWorld::stepSimulation.
+		mTimeSinceLastFixedStep += TimeManager::GetDeltaTime();
+		if (mTimeSinceLastFixedStep >= sFixedTimeStep)
+		{
+			const int numOfSteps = static_cast<int>(mTimeSinceLastFixedStep / sFixedTimeStep);
+			mTimeSinceLastFixedStep -= numOfSteps * sFixedTimeStep;
+		}
+	}
+
+	CopyTransformsFromBullet();
 
 	int numOfManifolds = mDispatcher->getNumManifolds();
 	for (int i = 0; i < numOfManifolds; ++i)
@@ -82,13 +210,93 @@ void Framework::Physics::AddCollisionObjectToWorld(btCollisionObject* object, Gr
 	}
 }
 
-void Framework::Physics::RemoveCollisionObjectFromWorld(std::unique_ptr<btCollisionObject> object)
+void Framework::Physics::RemoveCollisionObjectFromWorld(CollisionObjectPtr object)
 {
+	btRigidBody* body = btRigidBody::upcast(object.get());
+	const int index = body != nullptr ? body->getUserIndex2() : -1;
+
+	if (index >= 0)
+	{
+		btRigidBody* const last = mBodiesWithChangedTransforms.back();
+		mBodiesWithChangedTransforms[index] = last;
+		last->setUserIndex2(index);
+		mBodiesWithChangedTransforms.pop_back();
+		body->setUserIndex2(-1);
+	}
+
 	mWorld->removeCollisionObject(object.get());
 }
 
+void Framework::Physics::MarkTransformChanged(btRigidBody& body)
+{
+	if (body.getUserIndex2() < 0)
+	{
+		body.setUserIndex2(static_cast<int>(mBodiesWithChangedTransforms.size()));
+		mBodiesWithChangedTransforms.push_back(&body);
+	}
+}
+
+void Framework::Physics::CopyTransformsToBullet()
+{
+	for (btRigidBody* body : mBodiesWithChangedTransforms)
+	{
+		const Entity* owner = static_cast<const Entity*>(body->getUserPointer());
+		assert(owner != nullptr);
+
+		const btTransform transform = owner->GetTransform().ToBullet();
+		body->setWorldTransform(transform);
+		body->setInterpolationWorldTransform(transform);
+		body->activate();
+		body->setUserIndex2(-1);
+	}
+	mBodiesWithChangedTransforms.clear();
+}
+
+void Framework::Physics::CopyTransformsFromBullet()
+{
+	PROFILE_ZONE("Physics::CopyTransformsFromBullet");
+
+	// The bodies that are asleep have not moved since they were last copied.
+	const btAlignedObjectArray<btRigidBody*>& bodies = mWorld->getNonStaticRigidBodies();
+	const bool interpolate = !mScene.IsDeterministic();
+
+	for (int i = 0; i < bodies.size(); i++)
+	{
+		const btRigidBody* body = bodies[i];
+
+		if (!body->isActive()
+			|| body->isStaticOrKinematicObject())
+		{
+			continue;
+		}
+
+		Entity* owner = static_cast<Entity*>(body->getUserPointer());
+
+		if (owner == nullptr)
+		{
+			continue;
+		}
+
+		btTransform transform = body->getWorldTransform();
+
+		if (interpolate)
+		{
+			// Same as btDiscreteDynamicsWorld::synchronizeSingleMotionState, lags one fixed step behind to interpolate instead of extrapolate.
+			btTransformUtil::integrateTransform(body->getInterpolationWorldTransform(), body->getInterpolationLinearVelocity(), body->getInterpolationAngularVelocity(),
+				mTimeSinceLastFixedStep - sFixedTimeStep, transform);
+		}
+
+		Transform& ownerTransform = owner->GetTransform();
+		ownerTransform.SetLocalPosition(Math::ToGLM(transform.getOrigin()));
+		ownerTransform.SetLocalOrientation(Math::ToGLM(transform.getRotation()));
+	}
+}
+
 void Framework::Physics::Query(Inquirer& inquirer, const Transform& transform) const
 {
+	PROFILE_ZONE("Physics::Query");
+
+	// Keeps the capacity, so that repeated queries from the same inquirer stop allocating.
 	inquirer.mCollidedWith.clear();
 
 	btTransform bulletTransform = transform.ToBullet();
@@ -157,6 +365,8 @@ void Framework::Physics::Query(Inquirer& inquirer, const Transform& transform) c
 
 Framework::Physics::RayCastHit Framework::Physics::RayCast(const glm::vec3 start, glm::vec3 direction, float maxDistance) const
 {
+	PROFILE_ZONE("Physics::RayCast");
+
 	const TerrainData* const terrainData = mScene.mTerrain->GetData();
 
 	direction = normalize(direction);
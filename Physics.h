@@ -1,4 +1,5 @@
 #pragma once
+#include "CollisionObjectStorage.h"
 
 class btGhostPairCallback;
 class btPairCachingGhostObject;
@@ -38,6 +39,10 @@ namespace Framework
 
 		inline void SetDebugMode(int mode) { mDebugDrawer.setDebugMode(mode); }
 
+		// Set through the multithreadedPhysics setting. Bullet then spreads the narrow phase and the solving of the islands over the job system.
+		// Never the case in deterministic scenes, or when bullet was not built with BT_THREADSAFE.
+		inline bool IsMultithreaded() const { return mIsMultithreaded; }
+
 		void DebugDraw();
 
 		enum Group
@@ -65,7 +70,11 @@ namespace Framework
 		};
 
 		void AddCollisionObjectToWorld(btCollisionObject* object, Group group, Mask mask);
-		void RemoveCollisionObjectFromWorld(std::unique_ptr<btCollisionObject> object);
+		void RemoveCollisionObjectFromWorld(CollisionObjectPtr object);
+
+		// Rigid bodies are not kept in sync with the transform of their owner, bullet is the one that moves them. Call this after teleporting
+		// the owner, so that its transform is copied to the body before the next step.
+		void MarkTransformChanged(btRigidBody& body);
 
 		//-------------------------------------------------------------------------------------------------------------------------------------//
 		// https://www.executionunit.com/blog/2015/03/27/bullet-physics-query-objects-with-a-volume/ My source for the queries (thanks brian!)-//
@@ -94,14 +103,27 @@ namespace Framework
 		RayCastHit RayCast(const glm::vec3 start, glm::vec3 direction, float maxDistance) const;
 
 	private:
+		void CopyTransformsToBullet();
+		void CopyTransformsFromBullet();
+
+		static constexpr btScalar sFixedTimeStep = btScalar(1.0) / btScalar(60.0);
+
 		Scene& mScene;
 
 		DebugDrawer mDebugDrawer;
 
+		// Each body stores its index in here as its second user index, or -1 if it is not in here, so it can be found and removed in constant time.
+		std::vector<btRigidBody*> mBodiesWithChangedTransforms{};
+
+		// Mirrors the time bullet has left over after its last fixed step, which it keeps to itself. Used to interpolate between the last two steps.
+		btScalar mTimeSinceLastFixedStep{};
+
 		btBroadphaseInterface* mBroadPhase{};
 		btDefaultCollisionConfiguration* mCollisionConfiguration{};
 		btCollisionDispatcher* mDispatcher{};
-		btSequentialImpulseConstraintSolver* mConstraintSolver{};
+		btConstraintSolver* mConstraintSolver{};
 		btDiscreteDynamicsWorld* mWorld{};	
+
+		bool mIsMultithreaded{};
 	};
 }
\ No newline at end of file
@@ -27,6 +27,9 @@ RTS::Player::Player(Framework::Scene& scene, Framework::EntityId armyEntityId) :
 	mHighlightedIndicatorMeshId = Framework::AssetManager::Inst().GetAsset<Framework::Mesh>("models/highlightedindicator.obj")->GetMeshId();
 	mEnemyHighlightedIndicatorMeshId = Framework::AssetManager::Inst().GetAsset<Framework::Mesh>("models/enemyhighlightedindicator.obj")->GetMeshId();
 
+	// Handles the input and moves the camera, the units only change through the commands given.
+	mIsTickedEveryFrame = true;
+
 	mArmy = dynamic_cast<Army*>(scene.mEntityManager->TryGetEntity(armyEntityId).value_or(nullptr));
 }
 
@@ -42,7 +45,11 @@ void RTS::Player::Tick()
 
 	Framework::InputManager& input = Framework::InputManager::Inst();
 
-	if (input.GetInput(Framework::InputId::MOUSE_RIGHT).down)
+	const Replay* replay = Replay::TryGet(mScene);
+	const bool isWatchingReplay = replay != nullptr && !replay->IsRecording();
+
+	if (input.GetInput(Framework::InputId::MOUSE_RIGHT).down
+		&& !isWatchingReplay)
 	{
 		const Unit* hoveringOverEnemyUnit{};
 
@@ -59,10 +66,7 @@ void RTS::Player::Tick()
 
 		if (hoveringOverEnemyUnit != nullptr)
 		{
-			for (Unit* myUnit : selectedUnits)
-			{
-				myUnit->GiveCommand<CommandAttack>(hoveringOverEnemyUnit->GetId());
-			}
+			OrderAttack(OrderIssuer::player, selectedUnits, hoveringOverEnemyUnit->GetId());
 		}
 		else
 		{
@@ -74,7 +78,7 @@ void RTS::Player::Tick()
 
 			if (hit.mHit != nullptr)
 			{
-				FormFormation(std::move(selectedUnits), { hit.mPosition.x, hit.mPosition.z });
+				OrderFormation(OrderIssuer::player, std::move(selectedUnits), { hit.mPosition.x, hit.mPosition.z });
 			}
 		}
 	}
@@ -106,11 +110,7 @@ void RTS::Player::Deserialize(const Framework::Data::Scope& parentScope)
 	Framework::EntityId armyEntityId;
 	myScope.GetVariable("armyEntityId") >> armyEntityId;
 
-	mScene.mEntityManager->DelayedIdRequest(armyEntityId,
-		[](Entity& entity, void* me)
-		{
-			static_cast<Player*>(me)->SetArmy(static_cast<Army*>(&entity));
-		}, this);
+	mScene.mEntityManager->ResolveOnceLoaded(armyEntityId, mArmy);
 
 	myScope.GetVariable("selectedUnits") >> mSelection;
 	myScope.GetVariable("focusPos") >> mCameraController.mFocus.mPoint;
@@ -216,8 +216,8 @@ void RTS::Player::UpdateWhichUnitsAreSelected()
 	//	return;
 	//}
 
-	std::vector<Unit*> unitsInsideArea = mSelectingArea.has_value() ? CheckForUnits(mSelectingArea.value()) : CheckForUnits(glMousePos);
-	mHighlightedUnits = unitsInsideArea;
+	Framework::FrameVector<Unit*> unitsInsideArea = mSelectingArea.has_value() ? CheckForUnits(mSelectingArea.value()) : CheckForUnits(glMousePos);
+	mHighlightedUnits.assign(unitsInsideArea.begin(), unitsInsideArea.end());
 	
 	if (released)
 	{
@@ -293,9 +293,9 @@ void RTS::Player::UpdateSelectingArea()
 	}
 }
 
-std::vector<RTS::Unit*> RTS::Player::CheckForUnits(const glm::vec2 atScreenPosition) const
+Framework::FrameVector<RTS::Unit*> RTS::Player::CheckForUnits(const glm::vec2 atScreenPosition) const
 {
-	const std::vector<Unit*> allUnits = mScene.mEntityManager->GetEntities<Unit>();
+	const Framework::FrameVector<Unit*> allUnits = mScene.mEntityManager->GetEntities<Unit, Framework::FrameAllocator<Unit*>>();
 	const glm::mat4& viewProjection = mScene.mCamera->GetViewProjection();
 	constexpr float zFarInv = 1.0f / Framework::Camera::zFar;
 	const float currentZoom = mScene.mCamera->GetZoom();
@@ -333,15 +333,15 @@ std::vector<RTS::Unit*> RTS::Player::CheckForUnits(const glm::vec2 atScreenPosit
 		}
 	}
 
-	return bestUnit == nullptr ? std::vector<Unit*>{} : std::vector<Unit*>{ bestUnit };
+	return bestUnit == nullptr ? Framework::FrameVector<Unit*>{} : Framework::FrameVector<Unit*>{ bestUnit };
 }
 
-std::vector<RTS::Unit*> RTS::Player::CheckForUnits(const Framework::BoundingBox2D& inBox) const
+Framework::FrameVector<RTS::Unit*> RTS::Player::CheckForUnits(const Framework::BoundingBox2D& inBox) const
 {
-	const std::vector<Unit*> allUnits = mScene.mEntityManager->GetEntities<Unit>();
+	const Framework::FrameVector<Unit*> allUnits = mScene.mEntityManager->GetEntities<Unit, Framework::FrameAllocator<Unit*>>();
 	const glm::mat4& viewProjection = mScene.mCamera->GetViewProjection();
 
-	std::vector<Unit*> found{};
+	Framework::FrameVector<Unit*> found{};
 	found.reserve(allUnits.size());
 
 	for (Unit* unit : allUnits)
@@ -363,7 +363,7 @@ std::vector<RTS::Unit*> RTS::Player::CheckForUnits(const Framework::BoundingBox2
 	return found;
 }
 
-void RTS::Player::RemoveUnselectableUnits(std::vector<Unit*>& fromVector) const
+void RTS::Player::RemoveUnselectableUnits(Framework::FrameVector<Unit*>& fromVector) const
 {
 	for (size_t i = 0; i < fromVector.size();)
 	{
@@ -2,6 +2,7 @@
 #include "Entity.h"
 #include "BoundingBox2D.h"
 #include "CameraControllers.h"
+#include "FrameArena.h"
 
 namespace RTS
 {
@@ -19,6 +20,7 @@ namespace RTS
 
 		bool Serialize(Framework::Data::Scope& parentScope) const;
 		void Deserialize(const Framework::Data::Scope& parentScope);
+		inline bool HasStateBesidesTransform() const { return true; }
 
 		inline void SetArmy(Army* army) { mArmy = army; }
 
@@ -28,11 +30,12 @@ namespace RTS
 		void UpdateWhichUnitsAreSelected();
 
 		void UpdateSelectingArea();
-		std::vector<Unit*> CheckForUnits(const glm::vec2 atScreenPosition) const;
-		std::vector<Unit*> CheckForUnits(const Framework::BoundingBox2D& inBox) const;
+		// Allocated from the frame arena.
+		Framework::FrameVector<Unit*> CheckForUnits(const glm::vec2 atScreenPosition) const;
+		Framework::FrameVector<Unit*> CheckForUnits(const Framework::BoundingBox2D& inBox) const;
 
 		// Does not preserve order of vector!
-		void RemoveUnselectableUnits(std::vector<Unit*>& fromVector) const;
+		void RemoveUnselectableUnits(Framework::FrameVector<Unit*>& fromVector) const;
 
 		Army* mArmy{};
 
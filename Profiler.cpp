@@ -0,0 +1,279 @@
+#include "precomp.h"
+#include "Profiler.h"
+
+#include <filesystem>
+#include <iomanip>
+
+Framework::Profiler::ScopedZone::ScopedZone(const char* name) :
+	mName(name),
+	mStart(Clock::now()),
+	mAllocationsAtStart(AllocationTracker::GetOnThisThread())
+{
+	++Profiler::Inst().GetThreadBuffer().mDepth;
+}
+
+Framework::Profiler::ScopedZone::~ScopedZone()
+{
+	const Clock::time_point end = Clock::now();
+	const AllocationTracker::Counters allocations = AllocationTracker::GetOnThisThread() - mAllocationsAtStart;
+	ThreadBuffer& buffer = Profiler::Inst().GetThreadBuffer();
+
+	--buffer.mDepth;
+
+	std::lock_guard<std::mutex> lock(buffer.mMutex);
+	buffer.mZones[buffer.mNumOfZonesWritten % sNumOfZonesPerThread] = { mName, mStart, end, buffer.mDepth, allocations };
+	++buffer.mNumOfZonesWritten;
+}
+
+void Framework::Profiler::BeginFrame()
+{
+	mPreviousFrameStart = mFrameStart;
+	mFrameStart = Clock::now();
+}
+
+void Framework::Profiler::SetThreadName(const std::string& name)
+{
+	ThreadBuffer& buffer = GetThreadBuffer();
+
+	std::lock_guard<std::mutex> lock(buffer.mMutex);
+	buffer.mName = name;
+}
+
+Framework::Profiler::ThreadBuffer& Framework::Profiler::GetThreadBuffer()
+{
+	if (sThreadBuffer == nullptr)
+	{
+		std::lock_guard<std::mutex> lock(mThreadBuffersMutex);
+
+		std::unique_ptr<ThreadBuffer>& buffer = mThreadBuffers.emplace_back(std::make_unique<ThreadBuffer>());
+		buffer->mId = static_cast<uint>(mThreadBuffers.size() - 1);
+		buffer->mName = "Thread " + std::to_string(buffer->mId);
+		sThreadBuffer = buffer.get();
+	}
+	return *sThreadBuffer;
+}
+
+std::vector<Framework::Profiler::ThreadZones> Framework::Profiler::CollectZones(const Clock::time_point from, const Clock::time_point to) const
+{
+	std::vector<ThreadZones> threads{};
+	std::lock_guard<std::mutex> buffersLock(mThreadBuffersMutex);
+
+	for (const std::unique_ptr<ThreadBuffer>& buffer : mThreadBuffers)
+	{
+		std::lock_guard<std::mutex> lock(buffer->mMutex);
+
+		ThreadZones& thread = threads.emplace_back();
+		thread.mThreadName = buffer->mName;
+		thread.mThreadId = buffer->mId;
+
+		const size_t numOfZones = std::min(buffer->mNumOfZonesWritten, sNumOfZonesPerThread);
+		for (size_t i = buffer->mNumOfZonesWritten - numOfZones; i < buffer->mNumOfZonesWritten; i++)
+		{
+			const Zone& zone = buffer->mZones[i % sNumOfZonesPerThread];
+
+			if (zone.mEnd > from
+				&& zone.mStart < to)
+			{
+				thread.mZones.push_back(zone);
+			}
+		}
+	}
+	return threads;
+}
+
+void Framework::Profiler::DrawImGui()
+{
+	if (!mIsWindowOpen)
+	{
+		return;
+	}
+
+	if (!mIsPaused
+		&& mPreviousFrameStart != Clock::time_point{})
+	{
+		mShownFrameStart = mPreviousFrameStart;
+		mShownFrameEnd = mFrameStart;
+		mShownFrame = CollectZones(mShownFrameStart, mShownFrameEnd);
+	}
+
+	ImGui::SetNextWindowSize({ 800.0f, 300.0f }, ImGuiCond_FirstUseEver);
+	if (ImGui::Begin("Profiler", &mIsWindowOpen))
+	{
+		ImGui::Checkbox("Pause", &mIsPaused);
+
+		ImGui::SameLine();
+		if (ImGui::Button("Export trace"))
+		{
+			const std::string filePath = "profiles/trace_" + std::to_string(std::chrono::system_clock::now().time_since_epoch().count()) + ".json";
+			mExportStatus = ExportChromeTrace(filePath) ? "Exported to " + filePath : "Could not export";
+		}
+
+		if (!mExportStatus.empty())
+		{
+			ImGui::SameLine();
+			ImGui::TextUnformatted(mExportStatus.c_str());
+		}
+
+		const float frameDuration = std::chrono::duration<float, std::milli>(mShownFrameEnd - mShownFrameStart).count();
+		ImGui::Text("Frame took %.3f ms", frameDuration);
+
+		if (AllocationTracker::IsEnabled())
+		{
+			const AllocationTracker::Counters allocations = AllocationTracker::GetLastFrame();
+			ImGui::SameLine();
+			ImGui::Text("and made %llu allocations (%.1f KB) and %llu frees", static_cast<unsigned long long>(allocations.mNumOfAllocations),
+				static_cast<float>(allocations.mNumOfBytesAllocated) / 1024.0f, static_cast<unsigned long long>(allocations.mNumOfFrees));
+		}
+
+		constexpr float rowHeight = 20.0f;
+		const float width = ImGui::GetContentRegionAvail().x;
+		ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+		for (const ThreadZones& thread : mShownFrame)
+		{
+			if (thread.mZones.empty()
+				|| frameDuration <= 0.0f)
+			{
+				continue;
+			}
+
+			ImGui::TextUnformatted(thread.mThreadName.c_str());
+
+			uint maxDepth{};
+			for (const Zone& zone : thread.mZones)
+			{
+				maxDepth = std::max(maxDepth, zone.mDepth);
+			}
+
+			const ImVec2 origin = ImGui::GetCursorScreenPos();
+			ImGui::Dummy({ width, rowHeight * static_cast<float>(maxDepth + 1) });
+
+			for (const Zone& zone : thread.mZones)
+			{
+				// Zones that started in the previous frame or ended in the next one are cut off at the edges.
+				const float startMs = std::max(std::chrono::duration<float, std::milli>(zone.mStart - mShownFrameStart).count(), 0.0f);
+				const float endMs = std::min(std::chrono::duration<float, std::milli>(zone.mEnd - mShownFrameStart).count(), frameDuration);
+
+				const ImVec2 min = { origin.x + startMs / frameDuration * width, origin.y + static_cast<float>(zone.mDepth) * rowHeight };
+				const ImVec2 max = { std::max(origin.x + endMs / frameDuration * width, min.x + 1.0f), min.y + rowHeight - 1.0f };
+
+				// The same name always gets the same color.
+				const uint64_t nameHash = Math::Hash(reinterpret_cast<uintptr_t>(zone.mName));
+				const ImU32 color = IM_COL32(80 + nameHash % 120, 80 + (nameHash >> 8) % 120, 80 + (nameHash >> 16) % 120, 255);
+
+				drawList->AddRectFilled(min, max, color);
+
+				const ImVec2 textSize = ImGui::CalcTextSize(zone.mName);
+				if (textSize.x < max.x - min.x - 4.0f)
+				{
+					drawList->AddText({ min.x + 2.0f, min.y + (rowHeight - textSize.y) * 0.5f }, IM_COL32_WHITE, zone.mName);
+				}
+
+				if (ImGui::IsMouseHoveringRect(min, max))
+				{
+					const float duration = std::chrono::duration<float, std::milli>(zone.mEnd - zone.mStart).count();
+
+					if (AllocationTracker::IsEnabled())
+					{
+						ImGui::SetTooltip("%s: %.3f ms\n%llu allocations (%llu bytes), %llu frees", zone.mName, duration, static_cast<unsigned long long>(zone.mAllocations.mNumOfAllocations),
+							static_cast<unsigned long long>(zone.mAllocations.mNumOfBytesAllocated), static_cast<unsigned long long>(zone.mAllocations.mNumOfFrees));
+					}
+					else
+					{
+						ImGui::SetTooltip("%s: %.3f ms", zone.mName, duration);
+					}
+				}
+			}
+		}
+	}
+	ImGui::End();
+}
+
+// Zone and thread names can contain anything, file paths for example, which would otherwise break the trace.
+static void WriteJsonString(std::ostream& stream, std::string_view str)
+{
+	stream << '"';
+
+	for (const char c : str)
+	{
+		switch (c)
+		{
+		case '"': stream << "\\\""; break;
+		case '\\': stream << "\\\\"; break;
+		case '\n': stream << "\\n"; break;
+		case '\r': stream << "\\r"; break;
+		case '\t': stream << "\\t"; break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				constexpr std::string_view hexDigits = "0123456789abcdef";
+				stream << "\\u00" << hexDigits[c >> 4] << hexDigits[c & 0xf];
+			}
+			else
+			{
+				stream << c;
+			}
+		}
+	}
+
+	stream << '"';
+}
+
+bool Framework::Profiler::ExportChromeTrace(const std::string& filePath) const
+{
+	const std::vector<ThreadZones> threads = CollectZones();
+
+	Clock::time_point firstStart = Clock::time_point::max();
+	for (const ThreadZones& thread : threads)
+	{
+		for (const Zone& zone : thread.mZones)
+		{
+			firstStart = std::min(firstStart, zone.mStart);
+		}
+	}
+
+	const std::string fullPath = sDataRoot + filePath;
+	std::error_code error{};
+	std::filesystem::create_directories(std::filesystem::path(fullPath).parent_path(), error);
+
+	std::ofstream file(fullPath, std::ios::trunc);
+
+	if (!file.is_open())
+	{
+		LOGWARNING("Could not create trace " << filePath);
+		return false;
+	}
+
+	file << std::fixed << std::setprecision(3);
+	file << "{\"traceEvents\":[\n";
+	bool isFirstEvent = true;
+
+	for (const ThreadZones& thread : threads)
+	{
+		file << (isFirstEvent ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread.mThreadId << ",\"args\":{\"name\":";
+		WriteJsonString(file, thread.mThreadName);
+		file << "}}";
+		isFirstEvent = false;
+
+		for (const Zone& zone : thread.mZones)
+		{
+			// In microseconds.
+			const double start = std::chrono::duration<double, std::micro>(zone.mStart - firstStart).count();
+			const double duration = std::chrono::duration<double, std::micro>(zone.mEnd - zone.mStart).count();
+
+			file << ",\n{\"name\":";
+			WriteJsonString(file, zone.mName);
+			file << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread.mThreadId << ",\"ts\":" << start << ",\"dur\":" << duration
+				<< ",\"args\":{\"allocations\":" << zone.mAllocations.mNumOfAllocations << ",\"bytesAllocated\":" << zone.mAllocations.mNumOfBytesAllocated << ",\"frees\":" << zone.mAllocations.mNumOfFrees << "}}";
+		}
+	}
+
+	file << "\n]}\n";
+
+	if (!file.good())
+	{
+		LOGWARNING("Failed to write trace " << filePath);
+		return false;
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+#include "Singleton.h"
+#include "AllocationTracker.h"
+
+#include <mutex>
+#include <chrono>
+
+namespace Framework
+{
+	// Records how long the zones marked with PROFILE_ZONE took, on every thread. Each thread only keeps its most recent zones, so
+	// recording is cheap enough to always be on.
+	class Profiler :
+		public Singleton<Profiler>
+	{
+	private:
+		friend Singleton;
+		Profiler() = default;
+		~Profiler() = default;
+
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		// Ends the zone when it goes out of scope, use PROFILE_ZONE instead of constructing these directly.
+		class ScopedZone
+		{
+		public:
+			// The name is not copied, it has to outlive the profiler. String literals are fine.
+			ScopedZone(const char* name);
+			~ScopedZone();
+
+			ScopedZone(const ScopedZone&) = delete;
+			ScopedZone& operator=(const ScopedZone&) = delete;
+
+		private:
+			const char* mName{};
+			Clock::time_point mStart{};
+			AllocationTracker::Counters mAllocationsAtStart{};
+		};
+
+		// Called by the game at the start of every frame, the flame graph shows the last frame that completed.
+		void BeginFrame();
+
+		// Shows up in the flame graph and in the exported traces instead of a number.
+		void SetThreadName(const std::string& name);
+
+		inline bool IsWindowOpen() const { return mIsWindowOpen; }
+		inline void SetWindowOpen(const bool isOpen) { mIsWindowOpen = isOpen; }
+		void DrawImGui();
+
+		// Writes every zone that is still in the buffers in the Chrome trace event format, which can be opened in chrome://tracing or Perfetto.
+		bool ExportChromeTrace(const std::string& filePath) const;
+
+	private:
+		struct Zone
+		{
+			const char* mName{};
+			Clock::time_point mStart{};
+			Clock::time_point mEnd{};
+			uint mDepth{};
+
+			// Made by this thread while the zone was open, including those made in the zones inside it.
+			AllocationTracker::Counters mAllocations{};
+		};
+
+		static constexpr size_t sNumOfZonesPerThread = 1 << 14;
+
+		// Only the owning thread writes to it, the lock is only ever contended while the zones are being read.
+		struct ThreadBuffer
+		{
+			std::string mName{};
+			uint mId{};
+
+			std::array<Zone, sNumOfZonesPerThread> mZones{};
+			size_t mNumOfZonesWritten{};
+			mutable std::mutex mMutex{};
+
+			// Only accessed by the owning thread.
+			uint mDepth{};
+		};
+
+		struct ThreadZones
+		{
+			std::string mThreadName{};
+			uint mThreadId{};
+			std::vector<Zone> mZones{};
+		};
+
+		// Created the first time the calling thread records a zone, and kept until the game shuts down.
+		ThreadBuffer& GetThreadBuffer();
+		static inline thread_local ThreadBuffer* sThreadBuffer{};
+
+		// Only the zones that overlap with [from, to), pass the default values to get all of them.
+		std::vector<ThreadZones> CollectZones(const Clock::time_point from = Clock::time_point::min(), const Clock::time_point to = Clock::time_point::max()) const;
+
+		std::vector<std::unique_ptr<ThreadBuffer>> mThreadBuffers{};
+		mutable std::mutex mThreadBuffersMutex{};
+
+		Clock::time_point mFrameStart{};
+		Clock::time_point mPreviousFrameStart{};
+
+		bool mIsWindowOpen{};
+
+		// The frame shown in the flame graph, kept while paused.
+		bool mIsPaused{};
+		std::vector<ThreadZones> mShownFrame{};
+		Clock::time_point mShownFrameStart{};
+		Clock::time_point mShownFrameEnd{};
+		std::string mExportStatus{};
+	};
+}
+
+#define PROFILE_ZONE_CONCAT_INNER(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_INNER(a, b)
+
+// Times the rest of the enclosing scope.
+#define PROFILE_ZONE(name) const Framework::Profiler::ScopedZone PROFILE_ZONE_CONCAT(profileZone, __LINE__){ name }
\ No newline at end of file
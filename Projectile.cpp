@@ -33,13 +33,15 @@ RTS::Projectile::Projectile(Framework::Scene& scene, const glm::vec3& position,
         shape->calculateLocalInertia(mass, inertia);
     }
 
-    std::unique_ptr<btRigidBody> rigidBody = std::make_unique<btRigidBody>(mass, &myTransform, shape, inertia);
+    btRigidBody::btRigidBodyConstructionInfo constructionInfo{ mass, nullptr, shape, inertia };
+    constructionInfo.m_startWorldTransform = myTransform.ToBullet();
+
+    mCollisionObject = mRigidBodyStorage.Construct(constructionInfo);
+    btRigidBody* rigidBody = static_cast<btRigidBody*>(mCollisionObject.get());
 
     rigidBody->setFriction(100000.0f);
     rigidBody->setLinearVelocity(Framework::Math::ToBullet(velocity));
-
-    mCollisionObject = std::move(rigidBody);
-    mCollisionObject->setUserPointer(this);
+    rigidBody->setUserPointer(this);
 
     mScene.mPhysics->AddCollisionObjectToWorld(mCollisionObject.get(), Framework::Physics::Group::projectileGroup, Framework::Physics::Mask::projectileMask);
 
@@ -15,6 +15,7 @@ namespace RTS
 
 		bool Serialize(Framework::Data::Scope& parentScope) const override;
 		void Deserialize(const Framework::Data::Scope& parentScope) override;
+		inline bool HasStateBesidesTransform() const override { return true; }
 
 		void OnCollision(const btCollisionObject* object) override;
 
@@ -22,6 +23,7 @@ namespace RTS
 		void Hit();
 
 		static constexpr float sDirectHitDamage = 0.1f;
+		Framework::CollisionObjectStorage<btRigidBody> mRigidBodyStorage{};
 		float mExplosionForce{};
 		bool mHasBeenDestroyed{};
 	};
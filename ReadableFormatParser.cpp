@@ -0,0 +1,32 @@
+#include "precomp.h"
+#include "ReadableFormatParser.h"
+
+#include "Scope.h"
+
+Framework::Data::ScopeBuilder::ScopeBuilder(Scope& root) :
+	mOpenScopes({ &root })
+{
+	assert(root.mFormat == Format::readable);
+}
+
+void Framework::Data::ScopeBuilder::OnScopeBegin(std::string_view name)
+{
+	Scope& parent = *mOpenScopes.back();
+	parent.mChildren.emplace_back(Format::readable, InternedString{ name }, &parent);
+
+	mOpenScopes.push_back(&parent.mChildren.back());
+}
+
+void Framework::Data::ScopeBuilder::OnVariable(std::string_view name, std::string_view value)
+{
+	mOpenScopes.back()->mVariables.emplace_back(InternedString{ name }, value, Format::readable);
+}
+
+void Framework::Data::ScopeBuilder::OnScopeEnd()
+{
+	// The root is never closed, it was already there before we started.
+	if (mOpenScopes.size() > 1)
+	{
+		mOpenScopes.pop_back();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+#pragma once
+#include "MappedFile.h"
+
+namespace Framework::Data
+{
+	class Scope;
+
+	// Streams over the readable (.txt) format and reports what it comes across to a handler:
+	//	OnScopeBegin(std::string_view name)
+	//	OnVariable(std::string_view name, std::string_view value)
+	//	OnScopeEnd()
+	// Nothing is allocated or copied per line, the string_views point straight into the text and are only valid during the call.
+	// The handler is a template argument instead of an interface, so the calls can be inlined into the loop.
+	class ReadableFormatParser
+	{
+	public:
+		// The file is memory mapped. Missing and empty files do not produce any events.
+		template<typename Handler>
+		static void Parse(const std::string& filePath, Handler& handler);
+
+		template<typename Handler>
+		static void Parse(std::string_view text, Handler& handler);
+
+	private:
+		// Removes the indentation and line endings.
+		static std::string_view TrimLayout(std::string_view text);
+	};
+
+	// Builds the tree of scopes from the events of the ReadableFormatParser.
+	class ScopeBuilder
+	{
+	public:
+		ScopeBuilder(Scope& root);
+
+		void OnScopeBegin(std::string_view name);
+		void OnVariable(std::string_view name, std::string_view value);
+		void OnScopeEnd();
+
+	private:
+		// The scopes that have been opened but not closed yet, only the last one gets new children so none of them move.
+		std::vector<Scope*> mOpenScopes{};
+	};
+
+	template<typename Handler>
+	inline void ReadableFormatParser::Parse(const std::string& filePath, Handler& handler)
+	{
+		const MappedFile file{ filePath };
+
+		if (!file.IsOpen())
+		{
+			return;
+		}
+
+		Parse(std::string_view{ reinterpret_cast<const char*>(file.GetData()), file.GetSize() }, handler);
+	}
+
+	template<typename Handler>
+	inline void ReadableFormatParser::Parse(std::string_view text, Handler& handler)
+	{
+		size_t depth = 0;
+
+		while (!text.empty())
+		{
+			const size_t lineEnd = text.find('\n');
+			const std::string_view line = text.substr(0, lineEnd);
+			text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+
+			// Whichever comes first decides what the line is, so values are free to contain brackets.
+			const size_t markerPos = line.find_first_of("{=}");
+
+			if (markerPos == std::string_view::npos)
+			{
+				continue;
+			}
+
+			switch (line[markerPos])
+			{
+			case '{':
+			{
+				// name {
+				std::string_view name = TrimLayout(line.substr(0, markerPos));
+				if (!name.empty()
+					&& name.back() == ' ')
+				{
+					name.remove_suffix(1);
+				}
+
+				handler.OnScopeBegin(name);
+				++depth;
+				break;
+			}
+			case '=':
+			{
+				// name = value
+				std::string_view name = TrimLayout(line.substr(0, markerPos));
+				if (!name.empty()
+					&& name.back() == ' ')
+				{
+					name.remove_suffix(1);
+				}
+
+				std::string_view value = line.substr(markerPos + 1);
+				if (!value.empty()
+					&& value.front() == ' ')
+				{
+					value.remove_prefix(1);
+				}
+
+				handler.OnVariable(name, TrimLayout(value));
+				break;
+			}
+			default:
+				// A closing bracket that does not belong to any scope marks the end of the data.
+				if (depth == 0)
+				{
+					return;
+				}
+
+				handler.OnScopeEnd();
+				--depth;
+				break;
+			}
+		}
+
+		// Close whatever was left open at the end of the file.
+		for (; depth > 0; --depth)
+		{
+			handler.OnScopeEnd();
+		}
+	}
+
+	inline std::string_view ReadableFormatParser::TrimLayout(std::string_view text)
+	{
+		const auto isLayout = [](const char ch)
+			{
+				return ch == '\t'
+					|| ch == '\r'
+					|| ch == '\n';
+			};
+
+		while (!text.empty()
+			&& isLayout(text.front()))
+		{
+			text.remove_prefix(1);
+		}
+
+		while (!text.empty()
+			&& isLayout(text.back()))
+		{
+			text.remove_suffix(1);
+		}
+
+		return text;
+	}
+}
\ No newline at end of file
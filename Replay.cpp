@@ -0,0 +1,451 @@
+#include "precomp.h"
+#include "Replay.h"
+
+#include <filesystem>
+
+#include "Level.h"
+#include "Unit.h"
+#include "Commands.h"
+#include "EntityManager.h"
+#include "MappedFile.h"
+
+// Most numbers in a replay are small, so they are stored in 7 bits per byte with the top bit set on every byte but the last.
+static void WriteVarint(std::vector<uchar>& buffer, uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		buffer.push_back(static_cast<uchar>(value | 0x80));
+		value >>= 7;
+	}
+	buffer.push_back(static_cast<uchar>(value));
+}
+
+template<typename T>
+static void WriteRaw(std::vector<uchar>& buffer, const T& value)
+{
+	const uchar* bytes = reinterpret_cast<const uchar*>(&value);
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+static void WriteString(std::vector<uchar>& buffer, const std::string& string)
+{
+	WriteVarint(buffer, string.size());
+	buffer.insert(buffer.end(), string.begin(), string.end());
+}
+
+// Stops reading once anything goes out of bounds, after which every read returns 0.
+class ReplayReader
+{
+public:
+	ReplayReader(const std::byte* data, const size_t size) : mData(data), mSize(size) {}
+
+	inline bool HasFailed() const { return mHasFailed; }
+	inline size_t GetNumOfBytesLeft() const { return mSize - mOffset; }
+
+	uint64_t ReadVarint()
+	{
+		uint64_t value{};
+
+		for (uint shift = 0; shift < 64; shift += 7)
+		{
+			const uchar byte = ReadRaw<uchar>();
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+
+			if ((byte & 0x80) == 0)
+			{
+				return value;
+			}
+		}
+
+		mHasFailed = true;
+		return 0;
+	}
+
+	template<typename T>
+	T ReadRaw()
+	{
+		T value{};
+
+		if (mHasFailed
+			|| mSize - mOffset < sizeof(T))
+		{
+			mHasFailed = true;
+			return value;
+		}
+
+		memcpy(&value, mData + mOffset, sizeof(T));
+		mOffset += sizeof(T);
+		return value;
+	}
+
+	std::string ReadString()
+	{
+		const uint64_t size = ReadVarint();
+
+		if (mHasFailed
+			|| mSize - mOffset < size)
+		{
+			mHasFailed = true;
+			return {};
+		}
+
+		std::string string(reinterpret_cast<const char*>(mData + mOffset), static_cast<size_t>(size));
+		mOffset += static_cast<size_t>(size);
+		return string;
+	}
+
+private:
+	const std::byte* mData{};
+	size_t mSize{};
+	size_t mOffset{};
+	bool mHasFailed{};
+};
+
+RTS::Replay::Replay(const std::string& levelFile, const std::string& levelName) :
+	mLevelFile(levelFile),
+	mLevelName(levelName),
+	mIsRecording(true)
+{
+}
+
+std::unique_ptr<RTS::Replay> RTS::Replay::Load(const std::string& filePath)
+{
+	const Framework::MappedFile file(sDataRoot + filePath);
+
+	if (!file.IsOpen())
+	{
+		LOGWARNING("Could not open replay " << filePath);
+		return nullptr;
+	}
+
+	ReplayReader reader{ file.GetData(), file.GetSize() };
+
+	if (reader.ReadRaw<uint32_t>() != sMagic
+		|| reader.ReadRaw<uint32_t>() != sVersion)
+	{
+		LOGWARNING("Replay " << filePath << " is outdated or corrupted");
+		return nullptr;
+	}
+
+	std::unique_ptr<Replay> replay{ new Replay };
+
+	replay->mLevelFile = reader.ReadString();
+	replay->mLevelName = reader.ReadString();
+	replay->mNumOfSteps = static_cast<uint>(reader.ReadVarint());
+
+	// Both counts come from the file, the hashes also have to actually be in it before anything is allocated for them.
+	const uint64_t numOfStateHashes = reader.ReadVarint();
+	if (numOfStateHashes > replay->mNumOfSteps / sNumOfStepsPerStateHash
+		|| numOfStateHashes > reader.GetNumOfBytesLeft() / sizeof(uint64_t))
+	{
+		LOGWARNING("Replay " << filePath << " is outdated or corrupted");
+		return nullptr;
+	}
+
+	replay->mStateHashes.resize(static_cast<size_t>(numOfStateHashes));
+	for (uint64_t& hash : replay->mStateHashes)
+	{
+		hash = reader.ReadRaw<uint64_t>();
+	}
+
+	const uint64_t numOfOrders = reader.ReadVarint();
+	uint step{};
+
+	for (uint64_t i = 0; i < numOfOrders && !reader.HasFailed(); i++)
+	{
+		Order& order = replay->mOrders.emplace_back();
+
+		// Stored as the number of steps since the previous order.
+		step += static_cast<uint>(reader.ReadVarint());
+		order.mStep = step;
+
+		// The type is checked by the switch below, the issuer is a single bit and always valid.
+		const uchar typeAndIssuer = reader.ReadRaw<uchar>();
+		order.mType = static_cast<OrderType>(typeAndIssuer & 0x7f);
+		order.mIssuer = static_cast<OrderIssuer>(typeAndIssuer >> 7);
+
+		// Every id takes at least a byte, clamped so a corrupted count cannot allocate an enormous amount of memory. Reading fails soon after anyway.
+		order.mUnits.resize(static_cast<size_t>(std::min<uint64_t>(reader.ReadVarint(), reader.GetNumOfBytesLeft())));
+		for (Framework::EntityId& id : order.mUnits)
+		{
+			id = static_cast<Framework::EntityId>(reader.ReadVarint());
+		}
+
+		switch (order.mType)
+		{
+		case OrderType::moveTo:
+			order.mPosition = reader.ReadRaw<glm::vec2>();
+			if (reader.ReadRaw<uchar>())
+			{
+				order.mDesiredForward = reader.ReadRaw<glm::vec2>();
+			}
+			break;
+		case OrderType::attack:
+			order.mTarget = static_cast<Framework::EntityId>(reader.ReadVarint());
+			break;
+		case OrderType::formation:
+			order.mPosition = reader.ReadRaw<glm::vec2>();
+			if (reader.ReadRaw<uchar>())
+			{
+				order.mRotation = reader.ReadRaw<float>();
+			}
+			break;
+		case OrderType::aggroLevel:
+		{
+			const uchar aggroLevel = reader.ReadRaw<uchar>();
+			if (aggroLevel > static_cast<uchar>(AggroLevel::pursuit))
+			{
+				LOGWARNING("Replay " << filePath << " contains an unknown aggro level");
+				return nullptr;
+			}
+			order.mAggroLevel = static_cast<AggroLevel>(aggroLevel);
+			break;
+		}
+		default:
+			LOGWARNING("Replay " << filePath << " contains an unknown order");
+			return nullptr;
+		}
+	}
+
+	if (reader.HasFailed())
+	{
+		LOGWARNING("Replay " << filePath << " is outdated or corrupted");
+		return nullptr;
+	}
+
+	return replay;
+}
+
+bool RTS::Replay::Save(const std::string& filePath) const
+{
+	std::vector<uchar> buffer{};
+	buffer.reserve(mOrders.size() * 16 + mStateHashes.size() * sizeof(uint64_t) + 256);
+
+	WriteRaw(buffer, sMagic);
+	WriteRaw(buffer, sVersion);
+	WriteString(buffer, mLevelFile);
+	WriteString(buffer, mLevelName);
+	WriteVarint(buffer, mNumOfSteps);
+
+	WriteVarint(buffer, mStateHashes.size());
+	for (const uint64_t hash : mStateHashes)
+	{
+		WriteRaw(buffer, hash);
+	}
+
+	WriteVarint(buffer, mOrders.size());
+	uint previousStep{};
+
+	for (const Order& order : mOrders)
+	{
+		WriteVarint(buffer, order.mStep - previousStep);
+		previousStep = order.mStep;
+
+		WriteRaw(buffer, static_cast<uchar>(static_cast<uchar>(order.mType) | static_cast<uchar>(order.mIssuer) << 7));
+
+		WriteVarint(buffer, order.mUnits.size());
+		for (const Framework::EntityId id : order.mUnits)
+		{
+			WriteVarint(buffer, id);
+		}
+
+		switch (order.mType)
+		{
+		case OrderType::moveTo:
+			WriteRaw(buffer, order.mPosition);
+			WriteRaw(buffer, static_cast<uchar>(order.mDesiredForward.has_value()));
+			if (order.mDesiredForward.has_value())
+			{
+				WriteRaw(buffer, order.mDesiredForward.value());
+			}
+			break;
+		case OrderType::attack:
+			WriteVarint(buffer, order.mTarget);
+			break;
+		case OrderType::formation:
+			WriteRaw(buffer, order.mPosition);
+			WriteRaw(buffer, static_cast<uchar>(order.mRotation.has_value()));
+			if (order.mRotation.has_value())
+			{
+				WriteRaw(buffer, order.mRotation.value());
+			}
+			break;
+		case OrderType::aggroLevel:
+			WriteRaw(buffer, static_cast<uchar>(order.mAggroLevel));
+			break;
+		}
+	}
+
+	const std::string fullPath = sDataRoot + filePath;
+	std::error_code error{};
+	std::filesystem::create_directories(std::filesystem::path(fullPath).parent_path(), error);
+
+	std::ofstream file(fullPath, std::ios::binary | std::ios::trunc);
+
+	if (!file.is_open())
+	{
+		LOGWARNING("Could not create replay " << filePath);
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+	if (!file.good())
+	{
+		LOGWARNING("Failed to write replay " << filePath);
+		return false;
+	}
+	return true;
+}
+
+RTS::Replay* RTS::Replay::TryGet(Framework::Scene& scene)
+{
+	Level* level = dynamic_cast<Level*>(&scene);
+	return level != nullptr ? level->GetReplay() : nullptr;
+}
+
+void RTS::Replay::RecordMoveTo(const OrderIssuer issuer, const std::vector<Unit*>& units, const uint step, const glm::vec2 position, const std::optional<glm::vec2> desiredForward)
+{
+	Order& order = AddOrder(OrderType::moveTo, issuer, units, step);
+	order.mPosition = position;
+	order.mDesiredForward = desiredForward;
+}
+
+void RTS::Replay::RecordAttack(const OrderIssuer issuer, const std::vector<Unit*>& units, const uint step, const Framework::EntityId target)
+{
+	Order& order = AddOrder(OrderType::attack, issuer, units, step);
+	order.mTarget = target;
+}
+
+void RTS::Replay::RecordFormation(const OrderIssuer issuer, const std::vector<Unit*>& units, const uint step, const glm::vec2 position, const std::optional<float> rotation)
+{
+	Order& order = AddOrder(OrderType::formation, issuer, units, step);
+	order.mPosition = position;
+	order.mRotation = rotation;
+}
+
+void RTS::Replay::RecordAggroLevel(const OrderIssuer issuer, const std::vector<Unit*>& units, const uint step, const AggroLevel aggroLevel)
+{
+	Order& order = AddOrder(OrderType::aggroLevel, issuer, units, step);
+	order.mAggroLevel = aggroLevel;
+}
+
+RTS::Replay::Order& RTS::Replay::AddOrder(const OrderType type, const OrderIssuer issuer, const std::vector<Unit*>& units, const uint step)
+{
+	assert(mIsRecording);
+	assert(mOrders.empty() || mOrders.back().mStep <= step);
+
+	Order& order = mOrders.emplace_back();
+	order.mStep = step;
+	order.mType = type;
+	order.mIssuer = issuer;
+	order.mUnits.reserve(units.size());
+
+	for (const Unit* unit : units)
+	{
+		order.mUnits.push_back(unit->GetId());
+	}
+	return order;
+}
+
+void RTS::Replay::OnStepTaken(const uint numOfStepsTaken, const uint64_t stateHash)
+{
+	if (mIsRecording)
+	{
+		mNumOfSteps = numOfStepsTaken;
+
+		if (numOfStepsTaken % sNumOfStepsPerStateHash == 0)
+		{
+			mStateHashes.push_back(stateHash);
+		}
+	}
+	else
+	{
+		CheckStateHash(numOfStepsTaken, stateHash);
+	}
+}
+
+void RTS::Replay::IssueOrders(const OrderIssuer issuer, Framework::Scene& scene)
+{
+	assert(!mIsRecording);
+
+	const uint step = scene.GetNumOfStepsTaken();
+	size_t& next = mNextOrderToIssue[static_cast<size_t>(issuer)];
+
+	for (; next < mOrders.size() && mOrders[next].mStep <= step; next++)
+	{
+		const Order& order = mOrders[next];
+
+		if (order.mIssuer != issuer)
+		{
+			continue;
+		}
+
+		if (order.mStep != step)
+		{
+			LOGWARNING("Skipped replaying an order from step " << order.mStep << ", the replay will diverge");
+			continue;
+		}
+
+		// The units were all alive when the order was recorded, some can only be missing if the replay has already diverged.
+		std::vector<Unit*> units{};
+		units.reserve(order.mUnits.size());
+
+		for (const Framework::EntityId id : order.mUnits)
+		{
+			std::optional<Framework::Entity*> entity = scene.mEntityManager->TryGetEntity(id);
+			Unit* unit = entity.has_value() ? dynamic_cast<Unit*>(entity.value()) : nullptr;
+
+			if (unit != nullptr)
+			{
+				units.push_back(unit);
+			}
+		}
+
+		switch (order.mType)
+		{
+		case OrderType::moveTo:
+			for (Unit* unit : units)
+			{
+				unit->GiveCommand<CommandMoveTo>(order.mPosition, order.mDesiredForward);
+			}
+			break;
+		case OrderType::attack:
+			for (Unit* unit : units)
+			{
+				unit->GiveCommand<CommandAttack>(order.mTarget);
+			}
+			break;
+		case OrderType::formation:
+			if (!units.empty())
+			{
+				FormFormation(std::move(units), order.mPosition, order.mRotation);
+			}
+			break;
+		case OrderType::aggroLevel:
+			for (Unit* unit : units)
+			{
+				unit->SetAggroLevel(order.mAggroLevel);
+			}
+			break;
+		}
+	}
+}
+
+void RTS::Replay::CheckStateHash(const uint numOfStepsTaken, const uint64_t stateHash)
+{
+	if (mHasDiverged
+		|| numOfStepsTaken % sNumOfStepsPerStateHash != 0)
+	{
+		return;
+	}
+
+	const size_t index = numOfStepsTaken / sNumOfStepsPerStateHash - 1;
+
+	if (index < mStateHashes.size()
+		&& mStateHashes[index] != stateHash)
+	{
+		LOGWARNING("Replay of " << mLevelName << " diverged from the recording between steps " << numOfStepsTaken - sNumOfStepsPerStateHash << " and " << numOfStepsTaken);
+		mHasDiverged = true;
+	}
+}
\ No newline at end of file
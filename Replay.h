@@ -0,0 +1,90 @@
+#pragma once
+
+namespace Framework
+{
+	class Scene;
+}
+
+namespace RTS
+{
+	class Unit;
+
+	enum class OrderIssuer : uchar { player, opponent };
+
+	// The orders the player and the opponent gave during a deterministic level, along with the step at which they were given.
+	// Everything else plays out the same way every time, so issuing the same orders on the same level reproduces the entire battle.
+	class Replay
+	{
+	public:
+		// Starts an empty recording.
+		Replay(const std::string& levelFile, const std::string& levelName);
+
+		// Returns nothing if the file could not be read or was made for an older version.
+		static std::unique_ptr<Replay> Load(const std::string& filePath);
+		bool Save(const std::string& filePath) const;
+
+		// The replay of the level this scene is, if it has one.
+		static Replay* TryGet(Framework::Scene& scene);
+
+		inline bool IsRecording() const { return mIsRecording; }
+		inline const std::string& GetLevelFile() const { return mLevelFile; }
+		inline const std::string& GetLevelName() const { return mLevelName; }
+		inline uint GetNumOfSteps() const { return mNumOfSteps; }
+
+		void RecordMoveTo(const OrderIssuer issuer, const std::vector<Unit*>& units, const uint step, const glm::vec2 position, const std::optional<glm::vec2> desiredForward);
+		void RecordAttack(const OrderIssuer issuer, const std::vector<Unit*>& units, const uint step, const Framework::EntityId target);
+		void RecordFormation(const OrderIssuer issuer, const std::vector<Unit*>& units, const uint step, const glm::vec2 position, const std::optional<float> rotation);
+		void RecordAggroLevel(const OrderIssuer issuer, const std::vector<Unit*>& units, const uint step, const AggroLevel aggroLevel);
+
+		// Called after every step while recording, every so often the state hash is stored so that playback can detect when it diverges.
+		void OnStepTaken(const uint numOfStepsTaken, const uint64_t stateHash);
+
+		// Gives the orders this issuer gave at the current step of the scene again. Call them at the same moment they were given
+		// during recording: the player's before the step, the opponent's when it ticks.
+		void IssueOrders(const OrderIssuer issuer, Framework::Scene& scene);
+
+	private:
+		Replay() = default;
+
+		// Compares the state to the one that was recorded, logs a warning the first time they differ.
+		void CheckStateHash(const uint numOfStepsTaken, const uint64_t stateHash);
+
+		enum class OrderType : uchar { moveTo, attack, formation, aggroLevel };
+
+		struct Order
+		{
+			uint mStep{};
+			OrderType mType{};
+			OrderIssuer mIssuer{};
+			std::vector<Framework::EntityId> mUnits{};
+
+			glm::vec2 mPosition{};
+			std::optional<glm::vec2> mDesiredForward{};
+			std::optional<float> mRotation{};
+			Framework::EntityId mTarget{};
+			AggroLevel mAggroLevel{};
+		};
+
+		Order& AddOrder(const OrderType type, const OrderIssuer issuer, const std::vector<Unit*>& units, const uint step);
+
+		// Increase this whenever the encoding changes, or when a change to the simulation makes older replays play out differently.
+		static constexpr uint32_t sVersion = 1;
+		static constexpr uint32_t sMagic = 0x594c5052; // "RPLY"
+
+		static constexpr uint sNumOfStepsPerStateHash = 60;
+
+		std::string mLevelFile{};
+		std::string mLevelName{};
+
+		std::vector<Order> mOrders{};
+		// The state hash after every sNumOfStepsPerStateHash steps.
+		std::vector<uint64_t> mStateHashes{};
+		uint mNumOfSteps{};
+
+		bool mIsRecording{};
+
+		// Orders before these have already been issued again.
+		std::array<size_t, 2> mNextOrderToIssue{};
+		bool mHasDiverged{};
+	};
+}
\ No newline at end of file
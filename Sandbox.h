@@ -23,6 +23,10 @@ namespace RTS
 		void Tick() override;
 		void DrawImGui() override;
 
+	protected:
+		// Previews of a level that is still being edited are not worth keeping.
+		inline bool RecordsReplays() const override { return false; }
+
 	private:
 		void Save(const std::string& toFile) const;
 		static std::string GenerateLevelName();
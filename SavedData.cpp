@@ -4,13 +4,16 @@
 #include "DynamicBitset.h"
 #include "Variable.h"
 #include "Scope.h"
+#include "MappedSave.h"
+#include "ReadableFormatParser.h"
 
 std::unordered_map<std::string, std::weak_ptr<Framework::Data::Scope>> sInMemory{};
 
 Framework::Data::SavedData::SavedData(const std::string& filePath, const std::string& scopePath) :
 	mFilePath(sDataRoot + filePath),
 	mScopePath(scopePath),
-	mFormat(DetermineFormat(filePath))
+	mFileType(DetermineFileType(filePath)),
+	mFormat(mFileType == FileType::readable ? Format::readable : Format::binary)
 {
 	auto it = sInMemory.find(mFilePath);
 
@@ -67,12 +70,11 @@ void Framework::Data::SavedData::LoadFromReadableFormat()
 	assert(mGlobalScope == nullptr
 		&& "Has already been loaded in");
 
-	std::ifstream dataFile(mFilePath);
-	assert(dataFile.is_open());
+	mGlobalScope = std::make_shared<Scope>(Format::readable, "GlobalScope", nullptr);
 
-	mGlobalScope = std::make_shared<Scope>(dataFile, "GlobalScope", nullptr);
-
-	dataFile.close();
+	// Missing or empty files leave the global scope empty.
+	ScopeBuilder builder{ *mGlobalScope };
+	ReadableFormatParser::Parse(mFilePath, builder);
 }
 
 void Framework::Data::SavedData::LoadFromBinaryFormat()
@@ -80,7 +82,7 @@ void Framework::Data::SavedData::LoadFromBinaryFormat()
 	assert(mGlobalScope == nullptr
 		&& "Has already been loaded in");
 
-	assert(mFormat == Format::binary);
+	assert(mFileType == FileType::huffman);
 
 	const DB::dynamic_bitset bitset = DB::dynamic_bitset::deserialize(mFilePath);
 
@@ -95,17 +97,34 @@ void Framework::Data::SavedData::LoadFromBinaryFormat()
 	mGlobalScope = std::make_shared<Scope>(it, tree, nullptr);
 }
 
-Framework::Data::Format Framework::Data::SavedData::DetermineFormat(const std::string& filePath)
+void Framework::Data::SavedData::LoadFromMappedFormat()
+{
+	assert(mGlobalScope == nullptr
+		&& "Has already been loaded in");
+
+	assert(mFileType == FileType::mapped);
+
+	mGlobalScope = std::make_shared<Scope>(Format::binary, "GlobalScope", nullptr);
+
+	// An empty scope is kept if the file is empty or invalid.
+	MappedSave::Load(*mGlobalScope, mFilePath);
+}
+
+Framework::Data::SavedData::FileType Framework::Data::SavedData::DetermineFileType(const std::string& filePath)
 {
 	const std::string extension = filePath.substr(filePath.size() - 3);
 
 	if (extension == "txt")
 	{
-		return Format::readable;
+		return FileType::readable;
 	}
 	else if (extension == "dat")
 	{
-		return Format::binary;
+		return FileType::huffman;
+	}
+	else if (extension == "sav")
+	{
+		return FileType::mapped;
 	}
 	else
 	{
@@ -152,35 +171,58 @@ void Framework::Data::SavedData::Delete(const std::string& filePath)
 	}
 }
 
-void Framework::Data::SavedData::SaveInReadableFormat()
+bool Framework::Data::SavedData::SaveCopy(const Scope& globalScope, const std::string& filePath)
 {
-	assert(mFormat == Format::readable);
+	std::string root = { sDataRoot };
+	std::string fullPath = filePath.substr(0, root.size()) == root ? filePath : root + filePath;
+
+	return Save(globalScope, fullPath, DetermineFileType(filePath));
+}
 
-	std::ofstream dataFile(mFilePath);
+bool Framework::Data::SavedData::SaveInReadableFormat(const Scope& globalScope, const std::string& fullPath)
+{
+	assert(globalScope.mFormat == Format::readable);
+
+	std::ofstream dataFile(fullPath);
 	if (!dataFile.is_open())
 	{
-		LOGWARNING("Could not save to " << mFilePath << ", might be read only.");
-		return;
+		LOGWARNING("Could not save to " << fullPath << ", might be read only.");
+		return false;
 	}
 
-	mGlobalScope->Save(dataFile);
+	globalScope.Save(dataFile);
 
 	dataFile.close();
+	return true;
 }
 
-void Framework::Data::SavedData::SaveInBinaryFormat()
+bool Framework::Data::SavedData::SaveInBinaryFormat(const Scope& globalScope, const std::string& fullPath)
 {
-	assert(mFormat == Format::binary);
-
 	std::list<HuffmanTree<std::string, ushort>::DataFrequency> frequencies{};
-	mGlobalScope->GatherFrequencies(frequencies);
+	globalScope.GatherFrequencies(frequencies);
 	HuffmanTree<std::string, ushort> tree = { frequencies };
 
 	// First save everything to this bitset
 	DB::dynamic_bitset bitset{};
 
+	// Reserve enough for the tree and the scopes, so the bitset never has to reallocate while saving.
+	size_t maxTreeSizeInBytes = 2 * sizeof(size_t);
+	for (const HuffmanTree<std::string, ushort>::DataFrequency& frequency : frequencies)
+	{
+		// The code length, whether the length fits in a char, the length and the data.
+		maxTreeSizeInBytes += 2 + sizeof(size_t) + frequency.mData.size();
+	}
+	bitset.reserve(maxTreeSizeInBytes * DB::sNumOfBitsInByte + globalScope.CalculateMaxBinarySizeInBits());
+
 	tree.Serialize(bitset);
-	mGlobalScope->Save(bitset, tree);
+	globalScope.Save(bitset, tree);
 
-	bitset.serialize(mFilePath);
+	bitset.serialize(fullPath);
+	return true;
 }
+
+
+bool Framework::Data::SavedData::SaveInMappedFormat(const Scope& globalScope, const std::string& fullPath)
+{
+	return MappedSave::Save(globalScope, fullPath);
+}
\ No newline at end of file
@@ -16,19 +16,16 @@ namespace Framework::Data
 		SavedData(const SavedData&) = delete;
 
 		// Saves the global scope to file. (Not just the this instance's scope.
-		inline void Save()
+		// Returns false if the file could not be written.
+		inline bool Save() const
 		{
-			switch (mFormat)
-			{
-			case Format::binary:
-				SaveInBinaryFormat();
-				return;
-			case Format::readable:
-				SaveInReadableFormat();
-				return;
-			}
+			return Save(*mGlobalScope, mFilePath, mFileType);
 		}
 
+		// Writes the scope to a file without loading that file in, the extension decides the format. The data kept in memory for that file is
+		// not updated. Does not touch anything shared between instances, so this can be called from any thread, as long as nothing modifies the scope meanwhile.
+		static bool SaveCopy(const Scope& globalScope, const std::string& filePath);
+
 		// Loads ALL the Data from file, and updates each instance.
 		//static void ReloadAll();
 
@@ -46,25 +43,46 @@ namespace Framework::Data
 		static void Delete(const std::string& filePath);
 
 	private:
-		void SaveInReadableFormat();
-		void SaveInBinaryFormat();
+		// Both huffman (.dat) and mapped (.sav) files store their variables in the binary format.
+		enum class FileType : uchar { readable, huffman, mapped };
+
+		static inline bool Save(const Scope& globalScope, const std::string& fullPath, const FileType fileType)
+		{
+			switch (fileType)
+			{
+			case FileType::huffman:
+				return SaveInBinaryFormat(globalScope, fullPath);
+			case FileType::mapped:
+				return SaveInMappedFormat(globalScope, fullPath);
+			case FileType::readable:
+				return SaveInReadableFormat(globalScope, fullPath);
+			}
+			return false;
+		}
+		static bool SaveInReadableFormat(const Scope& globalScope, const std::string& fullPath);
+		static bool SaveInBinaryFormat(const Scope& globalScope, const std::string& fullPath);
+		static bool SaveInMappedFormat(const Scope& globalScope, const std::string& fullPath);
 
 		inline void Load()
 		{
-			switch (mFormat)
+			switch (mFileType)
 			{
-			case Format::binary:
+			case FileType::huffman:
 				LoadFromBinaryFormat();
 				return;
-			case Format::readable:
+			case FileType::mapped:
+				LoadFromMappedFormat();
+				return;
+			case FileType::readable:
 				LoadFromReadableFormat();
 				return;
 			}
 		}
 		void LoadFromReadableFormat();
 		void LoadFromBinaryFormat();
+		void LoadFromMappedFormat();
 
-		static Format DetermineFormat(const std::string& filepath);
+		static FileType DetermineFileType(const std::string& filepath);
 
 		std::shared_ptr<Scope> mGlobalScope{};
 
@@ -74,6 +92,7 @@ namespace Framework::Data
 		// An inputmanager for example could be focused on "playerdata/input", and will only be able to access the variables of that location and it's children.
 		const std::string mScopePath{};
 
+		const FileType mFileType{};
 		const Format mFormat{};
 	};
 }
\ No newline at end of file
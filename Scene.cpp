@@ -1,6 +1,8 @@
 #include "precomp.h"
 #include "Scene.h"
 
+#include <chrono>
+
 #include "game.h"
 #include "EntityManager.h"
 #include "Camera.h"
@@ -8,10 +10,40 @@
 #include "Physics.h"
 #include "SavedData.h"
 #include "TimeManager.h"
+#include "JobSystem.h"
+#include "Settings.h"
+#include "Profiler.h"
+#include "FrameArena.h"
+
+// Shared with the job that writes the files, so that either of them can outlive the other.
+struct Framework::Scene::BackgroundSave
+{
+	BackgroundSave(std::function<void(bool)>&& onCompleted) :
+		mOnCompleted(std::move(onCompleted))
+	{}
+
+	// Returns the global scope of the new file.
+	Data::Scope& AddFile(std::string filePath)
+	{
+		return mFiles.emplace_back(std::move(filePath), Data::Scope{ Data::Format::binary, "GlobalScope", nullptr }).second;
+	}
+
+	// Written in this order, the files after one that could not be written are skipped.
+	std::vector<std::pair<std::string, Data::Scope>> mFiles{};
+	std::function<void(bool)> mOnCompleted{};
+	bool mIsDelta{};
+
+	// Only read once mIsDone has been set.
+	bool mSucceeded{};
+	std::atomic<bool> mIsDone{};
+};
 
 Framework::Scene::Scene(Game& game, const std::string& levelFile, const std::string& levelName) :
 	mGame(game)
 {
+	// Read first, the physics depends on it.
+	Settings::Inst().GetSettings().GetVariable("deterministicSimulation") >> mIsDeterministic;
+
 	mPhysics = std::make_unique<Physics>(*this);
 	mCamera = std::make_unique<Camera>(*this);
 	mTerrain = std::make_unique<Terrain>(*this);
@@ -20,11 +52,30 @@ Framework::Scene::Scene(Game& game, const std::string& levelFile, const std::str
 	if (!levelFile.empty())
 	{
 		mSceneData = std::make_unique<Data::SavedData>(levelFile, levelName);
+
+		if (mSceneData->TryGetScope("Delta").has_value()
+			&& !ApplyDelta(mSceneData->GetScope()))
+		{
+			mHasFailedToLoad = true;
+		}
 	}
 }
 
 Framework::Scene::~Scene() = default;
 
+void Framework::Scene::SetIsDeterministic(const bool isDeterministic)
+{
+	assert(mNumOfStepsTaken == 0);
+
+	if (mIsDeterministic != isDeterministic)
+	{
+		mIsDeterministic = isDeterministic;
+
+		// Physics asserts that nothing has been added to its world yet.
+		mPhysics = std::make_unique<Physics>(*this);
+	}
+}
+
 uchar Framework::Scene::Deserialize(const uchar progress)
 {
 	if (mSceneData == nullptr)
@@ -49,7 +100,8 @@ uchar Framework::Scene::Deserialize(const uchar progress)
 		constexpr uchar progressStart = 30;
 		constexpr uchar progressEnd = 80;
 
-		const float entityProgress = mEntityManager->Deserialize(myScope, 5);
+		// The entities are decoded in parallel on the first call, what is left per entity is cheap enough to do many of them each frame.
+		const float entityProgress = mEntityManager->Deserialize(myScope, 100);
 
 		if (entityProgress == 1.0f)
 		{
@@ -75,15 +127,101 @@ uchar Framework::Scene::Deserialize(const uchar progress)
 
 void Framework::Scene::Tick()
 {
+	if (!mIsDeterministic)
+	{
+		Step();
+		mEntityManager->GetTickCosts().EndFrame();
+		return;
+	}
+
+	// Ticked with the actual delta time, the commands given by these are picked up by the next step.
+	mEntityManager->TickEntitiesTickedEveryFrame();
+
+	mTimeSinceStep += TimeManager::GetDeltaTime();
+
+	uint numOfSteps{};
+	TimeManager::SetFixedDeltaTime(sDeterministicStepSize);
+
+	while (mTimeSinceStep >= sDeterministicStepSize
+		&& numOfSteps < sMaxNumOfStepsPerTick)
+	{
+		TakeFixedStep();
+
+		mTimeSinceStep -= sDeterministicStepSize;
+		++numOfSteps;
+	}
+
+	TimeManager::SetFixedDeltaTime({});
+	mTimeSinceStep = std::min(mTimeSinceStep, sDeterministicStepSize);
+
+	mEntityManager->GetTickCosts().EndFrame();
+}
+
+void Framework::Scene::FastForward(const uint toStep)
+{
+	assert(mIsDeterministic);
+
+	TimeManager::SetFixedDeltaTime(sDeterministicStepSize);
+
+	while (mNumOfStepsTaken < toStep)
+	{
+		// Fast-forwarding can take thousands of steps in a single frame, nothing allocated from the arena outlives a step.
+		FrameArena::Inst().Reset();
+		TakeFixedStep();
+
+		// Nothing is drawn in between, so every step counts as a frame.
+		mEntityManager->GetTickCosts().EndFrame();
+	}
+
+	TimeManager::SetFixedDeltaTime({});
+}
+
+void Framework::Scene::TakeFixedStep()
+{
+	BeforeStep();
+	Step();
+
+	++mNumOfStepsTaken;
+	TimeManager::SetSimulatedTimePassed(GetSimulatedTimePassed());
+
+	mStateHash = CalculateStateHash();
+	AfterStep();
+}
+
+void Framework::Scene::Step()
+{
+	PROFILE_ZONE("Scene::Step");
+
 	mEntityManager->DeconstructDestroyedEntities();
-	mEntityManager->Tick();
+
+	if (mIsDeterministic)
+	{
+		mEntityManager->TickSimulatedEntities();
+	}
+	else
+	{
+		mEntityManager->Tick();
+	}
+
 	mPhysics->Tick();
 }
 
+uint64_t Framework::Scene::CalculateStateHash() const
+{
+	return mEntityManager->CalculateStateHash();
+}
+
 void Framework::Scene::Draw()
 {
+	// Checked here instead of in Tick, since derived scenes usually stop ticking while paused, which is when saving from the menu happens.
+	CheckBackgroundSave();
+
+	mEntityManager->UpdateWorldMatrices();
+
 	mCamera->DrawScene();
 	DrawImGui();
+
+	mEntityManager->GetTickCosts().DrawImGui();
 }
 
 void Framework::Scene::Unload()
@@ -99,7 +237,7 @@ void Framework::Scene::Unload()
 
 void Framework::Scene::Serialize(const std::string& saveName) const
 {
-	std::string filepath = "saves/" + saveName + ".dat";
+	std::string filepath = "saves/" + saveName + ".sav";
 
 	Framework::Data::SavedData::MakeEmpty(filepath);
 	Framework::Data::SavedData saveData = { filepath };
@@ -112,9 +250,168 @@ void Framework::Scene::Serialize(const std::string& saveName) const
 	saveData.Save();
 }
 
+bool Framework::Scene::SerializeAsync(const std::string& saveName, std::function<void(bool)> onCompleted, const bool asDelta)
+{
+	if (IsSaving())
+	{
+		return false;
+	}
+
+	mBackgroundSave = std::make_shared<BackgroundSave>(std::move(onCompleted));
+	mBackgroundSave->mIsDelta = asDelta;
+	mBackgroundSave->mFiles.reserve(2);
+
+	// Building the scopes only copies the values out of the entities, the expensive part is encoding them and writing the files.
+	if (!asDelta)
+	{
+		Serialize(mBackgroundSave->AddFile("saves/" + saveName + ".sav").AddChild(saveName));
+	}
+	else
+	{
+		const std::string keyframeName = saveName + std::string{ sKeyframeSuffix };
+
+		if (keyframeName != mKeyframeName
+			|| mNumOfDeltasSinceKeyframe >= sNumOfDeltasPerKeyframe)
+		{
+			mKeyframeName = keyframeName;
+			mKeyframeId = static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+			mNumOfDeltasSinceKeyframe = 0;
+
+			SerializeKeyframe(mBackgroundSave->AddFile("saves/" + keyframeName + ".sav").AddChild(keyframeName));
+		}
+		else
+		{
+			mNumOfDeltasSinceKeyframe++;
+		}
+
+		// Written after the keyframe, so the delta never refers to a keyframe that is not there yet.
+		SerializeDelta(mBackgroundSave->AddFile("saves/" + saveName + ".sav").AddChild(saveName));
+	}
+
+	JobSystem::Inst().Schedule([save = mBackgroundSave]()
+		{
+			save->mSucceeded = true;
+
+			for (const auto& [filePath, snapshot] : save->mFiles)
+			{
+				if (!Data::SavedData::SaveCopy(snapshot, filePath))
+				{
+					save->mSucceeded = false;
+					break;
+				}
+			}
+
+			save->mFiles.clear();
+			save->mIsDone.store(true, std::memory_order_release);
+		});
+
+	return true;
+}
+
+void Framework::Scene::CheckBackgroundSave()
+{
+	if (mBackgroundSave == nullptr
+		|| !mBackgroundSave->mIsDone.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	// Reset first, so the callback is able to start the next save.
+	const std::shared_ptr<BackgroundSave> save = std::move(mBackgroundSave);
+	mBackgroundSave.reset();
+
+	// The deltas that follow could be referring to a keyframe that is not there, start over with a new one.
+	if (save->mIsDelta
+		&& !save->mSucceeded)
+	{
+		mKeyframeName.clear();
+	}
+
+	if (save->mOnCompleted)
+	{
+		save->mOnCompleted(save->mSucceeded);
+	}
+}
+
 void Framework::Scene::Serialize(Data::Scope& myScope) const
 {
 	mCamera->Serialize(myScope);
 	mTerrain->Serialize(myScope);
 	mEntityManager->Serialize(myScope);
+}
+
+void Framework::Scene::SerializeKeyframe(Data::Scope& myScope)
+{
+	myScope.AddChild("Keyframe").AddVariable("id") << mKeyframeId;
+
+	mCamera->Serialize(myScope);
+	mTerrain->Serialize(myScope);
+	mEntityManager->SerializeKeyframe(myScope);
+}
+
+void Framework::Scene::SerializeDelta(Data::Scope& myScope) const
+{
+	Data::Scope& deltaScope = myScope.AddChild("Delta");
+	deltaScope.AddVariable("keyframe") << mKeyframeName;
+	deltaScope.AddVariable("keyframeId") << mKeyframeId;
+
+	mCamera->Serialize(myScope);
+	mTerrain->Serialize(myScope, false);
+	mEntityManager->SerializeDelta(myScope);
+}
+
+bool Framework::Scene::ApplyDelta(Data::Scope& myScope)
+{
+	const Data::Scope& deltaScope = myScope.GetScope("Delta");
+
+	std::string keyframeName{};
+	uint64_t keyframeId{};
+	deltaScope.GetVariable("keyframe") >> keyframeName;
+	deltaScope.GetVariable("keyframeId") >> keyframeId;
+
+	const Data::SavedData keyframeData = { "saves/" + keyframeName + ".sav" };
+	std::optional<Data::Scope*> keyframeOptionalScope = keyframeData.TryGetScope(keyframeName);
+	if (!keyframeOptionalScope.has_value())
+	{
+		LOGWARNING("Could not find keyframe " << keyframeName << ", the save can not be loaded without it");
+		return false;
+	}
+	Data::Scope& keyframeScope = *keyframeOptionalScope.value();
+
+	uint64_t savedKeyframeId{};
+	keyframeScope.GetVariable("Keyframe.id") >> savedKeyframeId;
+
+	if (savedKeyframeId != keyframeId)
+	{
+		// A newer keyframe was written, but the delta that goes with it was not. The keyframe is the most recent state we have.
+		LOGWARNING("Delta save does not belong to " << keyframeName << ", loading the keyframe instead");
+		// Only the contents are taken over, the scene keeps its own name. The marker that made it a keyframe is not part of the scene.
+		myScope.Clear();
+		myScope.GetVariables() = keyframeScope.GetVariables();
+
+		for (const Data::Scope& child : keyframeScope.GetChildren())
+		{
+			if (child.GetName() != "Keyframe")
+			{
+				myScope.AddChild(Data::Scope{ child });
+			}
+		}
+		return true;
+	}
+
+	Data::Scope& terrainScope = myScope.GetScope("Terrain");
+	Data::Scope& keyframeTerrainScope = keyframeScope.GetScope("Terrain");
+
+	uint64_t heightMapHash{};
+	uint64_t keyframeHeightMapHash{};
+	terrainScope.GetVariable("heightMapHash") >> heightMapHash;
+	keyframeTerrainScope.GetVariable("heightMapHash") >> keyframeHeightMapHash;
+
+	if (heightMapHash != keyframeHeightMapHash)
+	{
+		LOGWARNING("The heightmap changed after " << keyframeName << " was saved, using the heightmap of the keyframe");
+	}
+	terrainScope.GetVariables().push_back(std::move(keyframeTerrainScope.GetVariable("heightMap")));
+
+	return EntityManager::ApplyDelta(myScope, keyframeScope);
 }
\ No newline at end of file
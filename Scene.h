@@ -36,6 +36,35 @@ namespace Framework
 
 		void Serialize(const std::string& saveName) const;
 
+		// Takes a snapshot of the scene right away, the encoding and writing to file happen on a background thread so the game does not stall.
+		// onCompleted is called on the main thread once the file has been written, if this scene still exists by then. The argument is false if writing failed.
+		// Returns false without saving if the previous save has not completed yet.
+		// A delta save only writes what changed since its keyframe, which is written to a separate file every sNumOfDeltasPerKeyframe saves.
+		bool SerializeAsync(const std::string& saveName, std::function<void(bool)> onCompleted = {}, const bool asDelta = false);
+		inline bool IsSaving() const { return mBackgroundSave != nullptr; }
+
+		// Set when the file the scene was constructed with does not hold a complete scene, do not request to load it in that case.
+		inline bool HasFailedToLoad() const { return mHasFailedToLoad; }
+
+		// Appended to the name of a delta save to get the name of its keyframe.
+		static constexpr std::string_view sKeyframeSuffix = " (keyframe)";
+
+		// In deterministic mode the scene is ticked in fixed steps, so that the same level and the same inputs always play out exactly the same.
+		inline bool IsDeterministic() const { return mIsDeterministic; }
+		inline float GetSimulatedTimePassed() const { return static_cast<float>(mNumOfStepsTaken) * sDeterministicStepSize; }
+		inline uint GetNumOfStepsTaken() const { return mNumOfStepsTaken; }
+
+		// Takes fixed steps as fast as possible until toStep has been reached. Nothing is drawn and the entities ticked every frame are not ticked in the meantime.
+		void FastForward(const uint toStep);
+
+		// Hash of every entity's transform and rigid body after the last fixed step, compare them to find the step at which two runs diverged.
+		inline uint64_t GetStateHash() const { return mStateHash; }
+		uint64_t CalculateStateHash() const;
+
+		// Entities derive their random seed from this, set it before spawning them.
+		inline uint GetRandomSeed() const { return mRandomSeed; }
+		inline void SetRandomSeed(const uint seed) { mRandomSeed = seed; }
+
 		Game& mGame;
 
 		std::unique_ptr<Physics> mPhysics{};
@@ -47,5 +76,46 @@ namespace Framework
 		std::unique_ptr<Framework::Data::SavedData> mSceneData{};
 
 		virtual void Serialize(Data::Scope& parentScope) const;
+
+		// Only called in deterministic mode.
+		virtual void BeforeStep() {};
+		virtual void AfterStep() {};
+
+		// Only call this before the scene is loaded in, the physics is made again to match.
+		void SetIsDeterministic(const bool isDeterministic);
+
+	private:
+		void Step();
+		void TakeFixedStep();
+
+		void CheckBackgroundSave();
+
+		void SerializeKeyframe(Data::Scope& myScope);
+		void SerializeDelta(Data::Scope& myScope) const;
+		// Fills in everything the delta save left out using its keyframe, after which it can be loaded in like any other save.
+		// Returns false if the keyframe the delta was saved against is missing or incomplete, the scope is only partially filled in that case.
+		static bool ApplyDelta(Data::Scope& myScope);
+
+		struct BackgroundSave;
+		std::shared_ptr<BackgroundSave> mBackgroundSave{};
+
+		static constexpr uint sNumOfDeltasPerKeyframe = 10;
+
+		static constexpr float sDeterministicStepSize = 1.0f / 60.0f;
+		// Any time beyond this is dropped, the simulation slows down instead of taking even longer to catch up.
+		static constexpr uint sMaxNumOfStepsPerTick = 4;
+
+		bool mIsDeterministic{};
+		bool mHasFailedToLoad{};
+		float mTimeSinceStep{};
+		uint mNumOfStepsTaken{};
+		uint64_t mStateHash = Math::sEmptyHash;
+
+		uint mRandomSeed = 0x12345678;
+
+		// Empty until the first delta save, or after a keyframe could not be written.
+		std::string mKeyframeName{};
+		uint64_t mKeyframeId{};
+		uint mNumOfDeltasSinceKeyframe{};
 	};
 }
\ No newline at end of file
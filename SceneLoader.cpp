@@ -7,6 +7,7 @@
 #include "AssetManager.h"
 #include "Sprite.h"
 #include "Scene.h"
+#include "Profiler.h"
 
 Framework::SceneLoader::SceneLoader() = default;
 Framework::SceneLoader::~SceneLoader() = default;
@@ -36,10 +37,16 @@ void Framework::SceneLoader::StartLoading()
 	mActiveScene = std::move(mRequestedScene);
 	mRequestedScene.reset();
 	mLoadingProgress = 0;
+	mTimeSpentLoading = 0.0f;
+
+	// Deterministic scenes run on their own clock, starting from the moment they are loaded in.
+	TimeManager::SetSimulatedTimePassed(mActiveScene->IsDeterministic() ? std::optional<float>{ mActiveScene->GetSimulatedTimePassed() } : std::nullopt);
 }
 
 void Framework::SceneLoader::ContinueLoading()
 {
+	PROFILE_ZONE("SceneLoader::ContinueLoading");
+
 	if (!ShouldContinueLoading())
 	{
 		return;
@@ -78,7 +85,8 @@ void Framework::SceneLoader::DisplayLoadingScreen()
 
 	if (ImGui::Begin("Loading window", nullptr, windowFlags))
 	{
-		const float timePassed = TimeManager::GetTotalTimePassed();
+		mTimeSpentLoading += TimeManager::GetRawDeltaTime();
+		const float timePassed = mTimeSpentLoading;
 		const uint numOfFrames = mLoadingIcon->GetNumOfFrames();
 		const uint frame = static_cast<uint>(fmodf(timePassed, static_cast<float>(numOfFrames) / static_cast<float>(sLoadingScreenFPS)) * sLoadingScreenFPS);
 		mLoadingIcon->SetFrame(frame);
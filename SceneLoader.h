@@ -34,5 +34,8 @@ namespace Framework
 		std::shared_ptr<Sprite> mLoadingIcon{};
 
 		uchar mLoadingProgress{};
+
+		// Not using the total time passed, since that stands still while a deterministic scene is loading.
+		float mTimeSpentLoading{};
 	};
 }
\ No newline at end of file
@@ -1,17 +1,6 @@
 #include "precomp.h"
 #include "Scope.h"
 
-void Cleanse(std::string& in)
-{
-	in.erase(std::remove_if(in.begin(), in.end(),
-		[](unsigned char x)
-		{
-			return x == '\t'
-				|| x == '\n'
-				|| x == '\r';
-		}), in.end());
-}
-
 Framework::Data::Scope::Scope(const Format format, const std::string& name, Scope* parent) :
 	mName(name),
 	mParent(parent),
@@ -21,49 +10,13 @@ Framework::Data::Scope::Scope(const Format format, const std::string& name, Scop
 		|| mParent->mFormat == format);
 }
 
-Framework::Data::Scope::Scope(std::ifstream& dataFile, const std::string& name, Scope* parent) :
+Framework::Data::Scope::Scope(const Format format, const InternedString name, Scope* parent) :
 	mName(name),
 	mParent(parent),
-	mFormat(Format::readable)
+	mFormat(format)
 {
-	std::string line;
-	while (getline(dataFile, line))
-	{
-		// If line contains {, consider it the start of a new location.
-		if (line.find('{') != std::string::npos)
-		{
-			std::string childName = line;
-
-			Cleanse(childName);
-
-			childName.pop_back(); // Remove '{'
-			childName.pop_back(); // Remove ' '
-
-			mChildren.emplace_back(dataFile, childName, this);
-			continue;
-		}
-
-		// If line contains a =, consider it a variable.
-		size_t equalSignPos = line.find('=');
-		if (equalSignPos != std::string::npos)
-		{
-			std::string varName = line.substr(0, equalSignPos - 1);
-
-			Cleanse(varName);
-
-			std::string varVal = line.substr(equalSignPos + 2);
-			Cleanse(varVal);
-
-			mVariables.emplace_back(varName, varVal, mFormat);
-			continue;
-		}
-
-		// If a line contains }, consider it the end of this location.
-		if (line.find('}') != std::string::npos)
-		{
-			return;
-		}
-	}
+	assert(mParent == nullptr
+		|| mParent->mFormat == format);
 }
 
 Framework::Data::Scope::Scope(DB::dynamic_bitset::const_iterator& it, const HuffmanTree<std::string, ushort>& huffmanTree, Scope* parent) :
@@ -79,10 +32,11 @@ Framework::Data::Scope::Scope(DB::dynamic_bitset::const_iterator& it, const Huff
 		DB::bit isThisTheFinalOne = it;
 		++it;
 
-		std::string varName = huffmanTree.Decode(it);
-		std::string varValue = it.GetSource()->extract<std::string>(it);
+		const InternedString varName{ huffmanTree.Decode(it) };
+		Variable& variable = mVariables.emplace_back(varName, std::string_view{}, Format::binary);
 
-		mVariables.emplace_back(std::move(varName), std::move(varValue), Format::binary);
+		const size_t valueSize = DB::dynamic_bitset::extract_string_size(it);
+		DB::dynamic_bitset::extract(variable.ResizeValue(valueSize), valueSize, it);
 
 		if (isThisTheFinalOne)
 		{
@@ -109,12 +63,41 @@ Framework::Data::Scope::Scope(DB::dynamic_bitset::const_iterator& it, const Huff
 
 Framework::Data::Scope::~Scope() = default;
 
+Framework::Data::Scope::Scope(const Scope& other) :
+	mName(other.mName),
+	mParent(other.mParent),
+	mFormat(other.mFormat),
+	mChildren(other.mChildren),
+	mVariables(other.mVariables)
+{
+	UpdateParentOfChildren();
+}
+
+Framework::Data::Scope::Scope(Scope&& other) noexcept :
+	mName(std::move(other.mName)),
+	mParent(other.mParent),
+	mFormat(other.mFormat),
+	mChildren(std::move(other.mChildren)),
+	mVariables(std::move(other.mVariables)),
+	mChildIndex(std::move(other.mChildIndex)),
+	mVariableIndex(std::move(other.mVariableIndex))
+{
+	UpdateParentOfChildren();
+}
+
 void Framework::Data::Scope::operator=(const Scope& other)
 {
 	assert(other.mFormat == mFormat);
 	mChildren = other.GetChildren();
 	mVariables = other.GetVariables();
+	mChildIndex.Invalidate();
+	mVariableIndex.Invalidate();
+
+	UpdateParentOfChildren();
+}
 
+void Framework::Data::Scope::UpdateParentOfChildren()
+{
 	for (Scope& child : mChildren)
 	{
 		child.mParent = this;
@@ -125,31 +108,8 @@ std::optional<const Framework::Data::Scope*> Framework::Data::Scope::TryGetScope
 {
 	assert(!path.empty());
 
-	size_t firstPeriod = path.find_first_of('.');
-	bool endOfPath = firstPeriod == std::string::npos;
-	std::string lookingFor = endOfPath ? path : path.substr(0, firstPeriod);
-	
-	auto it = find_if(mChildren.begin(), mChildren.end(),
-		[lookingFor](const Scope& s)
-		{
-			return s.mName == lookingFor;
-		});
-
-	if (it == mChildren.end())
-	{
-		return {};
-	}
-
-	if (endOfPath)
-	{
-		return &*it;
-	}
-	else
-	{
-		std::string newPath = path;
-		newPath.erase(0, firstPeriod + 1);
-		return it->TryGetScope(newPath); // Continue searching with the first part of the path cut off.
-	}
+	const Scope* scope = FindScope(path);
+	return scope != nullptr ? std::optional<const Scope*>{ scope } : std::optional<const Scope*>{};
 }
 
 std::optional<Framework::Data::Scope*> Framework::Data::Scope::TryGetScope(const std::string& path)
@@ -190,7 +150,7 @@ void Framework::Data::Scope::Save(std::ofstream& toFile, uint8_t numOfIndentatio
 			indentation += '\t';
 		}
 
-		toFile << indentation << mName << " {" << std::endl;
+		toFile << indentation << GetName() << " {" << std::endl;
 		++numOfIndentations;
 	}
 
@@ -216,7 +176,7 @@ void Framework::Data::Scope::Save(DB::dynamic_bitset& toBitset, HuffmanTree<std:
 {
 	assert(mFormat == Format::binary);
 
-	huffmanTree.Encode(toBitset, mName);
+	huffmanTree.Encode(toBitset, GetName());
 
 	// This scope has variables
 	toBitset.push_back(!mVariables.empty());
@@ -244,7 +204,7 @@ void Framework::Data::Scope::Save(DB::dynamic_bitset& toBitset, HuffmanTree<std:
 
 void Framework::Data::Scope::GatherFrequencies(std::list<HuffmanTree<std::string, ushort>::DataFrequency>& dataFrequencies) const
 {
-	HuffmanTree<std::string, ushort>::IncrementFrequency(dataFrequencies, mName);
+	HuffmanTree<std::string, ushort>::IncrementFrequency(dataFrequencies, GetName());
 
 	for (const Variable& var : mVariables)
 	{
@@ -257,15 +217,66 @@ void Framework::Data::Scope::GatherFrequencies(std::list<HuffmanTree<std::string
 	}
 }
 
+size_t Framework::Data::Scope::CalculateMaxBinarySizeInBits() const
+{
+	using Tree = HuffmanTree<std::string, ushort>;
+
+	// The name, and whether there are variables and children.
+	size_t numOfBits = Tree::sMaxCodeLength + 2;
+
+	for (const Variable& var : mVariables)
+	{
+		const size_t valueSize = var.GetValue().size();
+		const size_t sizeOfLength = valueSize > std::numeric_limits<unsigned char>::max() ? sizeof(size_t) : sizeof(unsigned char);
+
+		// Whether it's the final one, the name, whether the length fits in a char, the length and the value.
+		numOfBits += 1 + Tree::sMaxCodeLength + 1 + (sizeOfLength + valueSize) * DB::sNumOfBitsInByte;
+	}
+
+	for (const Scope& child : mChildren)
+	{
+		numOfBits += 1 + child.CalculateMaxBinarySizeInBits();
+	}
+
+	return numOfBits;
+}
+
+uint64_t Framework::Data::Scope::CalculateHash(uint64_t hash) const
+{
+	// The sizes are included so that moving characters from one name or value to the next changes the hash.
+	const std::string& name = GetName();
+	hash = Math::Hash(name.size(), hash);
+	hash = Math::HashBytes(name.data(), name.size(), hash);
+
+	hash = Math::Hash(mVariables.size(), hash);
+	for (const Variable& variable : mVariables)
+	{
+		const std::string& variableName = variable.GetName();
+		hash = Math::Hash(variableName.size(), hash);
+		hash = Math::HashBytes(variableName.data(), variableName.size(), hash);
+
+		const std::string_view value = variable.GetValue();
+		hash = Math::Hash(value.size(), hash);
+		hash = Math::HashBytes(value.data(), value.size(), hash);
+	}
+
+	hash = Math::Hash(mChildren.size(), hash);
+	for (const Scope& child : mChildren)
+	{
+		hash = child.CalculateHash(hash);
+	}
+	return hash;
+}
+
 std::string Framework::Data::Scope::GetPath() const
 {
 	if (mParent == nullptr)
 	{
-		return mName;
+		return GetName();
 	}
 	else
 	{
-		return mParent->GetPath() + "." + mName;
+		return mParent->GetPath() + "." + GetName();
 	}
 }
 
@@ -286,54 +297,171 @@ std::optional<Framework::Data::Variable*> Framework::Data::Scope::TryGetVariable
 
 std::optional<const Framework::Data::Variable*> Framework::Data::Scope::TryGetVariablePtr(const std::string& path, const bool) const
 {
-	size_t lastPeriod = path.find_last_of('.');
+	const Variable* variable = FindVariable(path);
+	return variable != nullptr ? std::optional<const Variable*>{ variable } : std::optional<const Variable*>{};
+}
+
+const Framework::Data::Scope* Framework::Data::Scope::FindScope(std::string_view path) const
+{
+	const Scope* current = this;
 
-	if (lastPeriod == std::string::npos)
+	while (true)
 	{
-		auto it = find_if(mVariables.begin(), mVariables.end(),
-			[path](const Variable& v)
-			{
-				return v.GetName() == path;
-			});
+		const size_t firstPeriod = path.find('.');
 
-		if (it == mVariables.end())
+		// If the name was never interned, there cannot be a scope with that name.
+		const std::optional<InternedString> lookingFor = InternedString::TryFind(path.substr(0, firstPeriod));
+		if (!lookingFor.has_value())
 		{
-			return {};
+			return nullptr;
 		}
-		else
+
+		const std::optional<size_t> position = current->mChildIndex.Find(current->mChildren, *lookingFor);
+		if (!position.has_value())
 		{
-			return &*it;
+			return nullptr;
 		}
+
+		current = &current->mChildren[*position];
+
+		if (firstPeriod == std::string_view::npos)
+		{
+			return current;
+		}
+
+		// Continue searching with the first part of the path cut off.
+		path.remove_prefix(firstPeriod + 1);
 	}
+}
+
+const Framework::Data::Variable* Framework::Data::Scope::FindVariable(std::string_view path) const
+{
+	const Scope* variableLocation = this;
+	const size_t lastPeriod = path.find_last_of('.');
 
 	// If this location does not contain the variable, find the location that does.
-	std::string varName = path.substr(lastPeriod + 1, path.size());
-	std::string locationPath = path.substr(0, lastPeriod);
+	if (lastPeriod != std::string_view::npos)
+	{
+		variableLocation = FindScope(path.substr(0, lastPeriod));
+		path.remove_prefix(lastPeriod + 1);
 
-	std::optional<const Scope*> variableLocation = TryGetScope(locationPath);
+		if (variableLocation == nullptr)
+		{
+			return nullptr;
+		}
+	}
 
-	if (variableLocation.has_value())
+	const std::optional<InternedString> varName = InternedString::TryFind(path);
+	if (!varName.has_value())
 	{
-		return variableLocation.value()->TryGetVariablePtr(varName);
+		return nullptr;
 	}
-	else
+
+	const std::optional<size_t> position = variableLocation->mVariableIndex.Find(variableLocation->mVariables, *varName);
+	return position.has_value() ? &variableLocation->mVariables[*position] : nullptr;
+}
+
+template<typename ElementType>
+std::optional<size_t> Framework::Data::Scope::NameIndex::Find(const std::vector<ElementType>& elements, const InternedString name)
+{
+	if (elements.size() < sMinNumOfElementsToIndex)
 	{
+		for (size_t i = 0; i < elements.size(); i++)
+		{
+			if (elements[i].GetInternedName() == name)
+			{
+				return i;
+			}
+		}
 		return {};
 	}
+
+	// Keep at least half of the slots empty, so the probes stay short.
+	if (elements.size() < mNumOfIndexed
+		|| mSlots.size() < elements.size() * 2)
+	{
+		size_t numOfSlots = sMinNumOfElementsToIndex * 4;
+		while (numOfSlots < elements.size() * 4)
+		{
+			numOfSlots *= 2;
+		}
+
+		mSlots.assign(numOfSlots, 0);
+		mNumOfIndexed = 0;
+	}
+
+	for (; mNumOfIndexed < elements.size(); mNumOfIndexed++)
+	{
+		Insert(elements, mNumOfIndexed);
+	}
+
+	const size_t mask = mSlots.size() - 1;
+	for (size_t slot = name.GetHash() & mask; mSlots[slot] != 0; slot = (slot + 1) & mask)
+	{
+		const size_t position = mSlots[slot] - 1;
+
+		if (elements[position].GetInternedName() == name)
+		{
+			return position;
+		}
+	}
+
+	return {};
+}
+
+template<typename ElementType>
+void Framework::Data::Scope::NameIndex::Insert(const std::vector<ElementType>& elements, const size_t position)
+{
+	const InternedString name = elements[position].GetInternedName();
+	const size_t mask = mSlots.size() - 1;
+
+	for (size_t slot = name.GetHash() & mask;; slot = (slot + 1) & mask)
+	{
+		if (mSlots[slot] == 0)
+		{
+			mSlots[slot] = static_cast<uint32_t>(position + 1);
+			return;
+		}
+
+		// Only the first one with this name can be found.
+		if (elements[mSlots[slot] - 1].GetInternedName() == name)
+		{
+			return;
+		}
+	}
 }
 
 Framework::Data::Variable& Framework::Data::Scope::AddVariable(const std::string& variableName)
 {
-	mVariables.emplace_back(variableName, "", mFormat);
+	return AddVariable(InternedString{ variableName });
+}
+
+Framework::Data::Variable& Framework::Data::Scope::AddVariable(const InternedString variableName)
+{
+	mVariables.emplace_back(variableName, std::string{}, mFormat);
 	return mVariables.back();
 }
 
 Framework::Data::Scope& Framework::Data::Scope::AddChild(const std::string& name)
+{
+	return AddChild(InternedString{ name });
+}
+
+Framework::Data::Scope& Framework::Data::Scope::AddChild(const InternedString name)
 {
 	mChildren.emplace_back(mFormat, name, this);
 	return mChildren.back();
 }
 
+Framework::Data::Scope& Framework::Data::Scope::AddChild(Scope&& child)
+{
+	assert(child.mFormat == mFormat);
+
+	Scope& added = mChildren.emplace_back(std::move(child));
+	added.mParent = this;
+	return added;
+}
+
 void Framework::Data::Scope::RemoveScope(const std::string& scopeName)
 {
 	mChildren.erase(std::remove_if(mChildren.begin(), mChildren.end(),
@@ -341,4 +469,16 @@ void Framework::Data::Scope::RemoveScope(const std::string& scopeName)
 		{
 			return child.GetName() == scopeName;
 		}), mChildren.end());
+
+	mChildIndex.Invalidate();
+}
+
+void Framework::Data::Scope::SetName(const std::string& name)
+{
+	mName = InternedString{ name };
+
+	if (mParent != nullptr)
+	{
+		mParent->mChildIndex.Invalidate();
+	}
 }
\ No newline at end of file
@@ -12,10 +12,14 @@ namespace Framework::Data
 	{
 	public:
 		Scope(const Format format, const std::string& name, Scope* parent);
-		Scope(std::ifstream& dataFile, const std::string& name, Scope* parent);
+		Scope(const Format format, const InternedString name, Scope* parent);
 		Scope(DB::dynamic_bitset::const_iterator& it, const HuffmanTree<std::string, ushort>& huffmanTree, Scope* parent);
 		~Scope();
 
+		// The children are told where their parent is now, so the scopes can safely be stored in vectors.
+		Scope(const Scope& other);
+		Scope(Scope&& other) noexcept;
+
 		// The original name is kept
 		void operator=(const Scope& other);
 
@@ -33,34 +37,75 @@ namespace Framework::Data
 		// Dummy default value can be used to specify the const version.
 		std::optional<const Variable*> TryGetVariablePtr(const std::string& path, const bool = false) const;
 
+		// The non const versions allow the children and variables to be changed in any way, so they will be indexed again on the next lookup.
 		inline const std::vector<Scope>& GetChildren() const { return mChildren; }
-		inline std::vector<Scope>& GetChildren() { return mChildren; }
+		inline std::vector<Scope>& GetChildren() { mChildIndex.Invalidate(); return mChildren; }
 
 		inline const std::vector<Variable>& GetVariables() const { return mVariables; }
-		inline std::vector<Variable>& GetVariables() { return mVariables; }
+		inline std::vector<Variable>& GetVariables() { mVariableIndex.Invalidate(); return mVariables; }
 
 		Variable& AddVariable(const std::string& variableName);
+		Variable& AddVariable(const InternedString variableName);
 		Scope& AddChild(const std::string& scopeName);
+		Scope& AddChild(const InternedString scopeName);
+		// Takes over the child along with everything inside of it.
+		Scope& AddChild(Scope&& child);
 
 		void RemoveScope(const std::string& scopeName);
 
-		inline const std::string& GetName() const { return mName; }
-		inline void SetName(const std::string& name) { mName = name; }
+		inline const std::string& GetName() const { return mName.GetString(); }
+		inline InternedString GetInternedName() const { return mName; }
+		void SetName(const std::string& name);
 
 		inline Scope* GetParent() const { return mParent; }
 		std::string GetPath() const;
 		
-		inline void Clear() { mChildren.clear(); mVariables.clear(); }
+		// Covers the names and values of everything inside this scope as well, two scopes with the same hash are almost certainly the same.
+		uint64_t CalculateHash(uint64_t hash = Math::sEmptyHash) const;
+
+		inline void Clear() { mChildren.clear(); mVariables.clear(); mChildIndex.Invalidate(); mVariableIndex.Invalidate(); }
 
 	private:
 		friend class SavedData;
+		friend class ScopeBuilder;
 		void Save(std::ofstream& toFile, uint8_t numOfIndentations = 0) const;
 		void Save(DB::dynamic_bitset& toBitset, HuffmanTree<std::string, ushort>& huffmanTree) const;
 		
 		// Needed for constructing the Huffman tree
 		void GatherFrequencies(std::list<HuffmanTree<std::string, ushort>::DataFrequency>& dataFrequencies) const;
 
-		std::string mName{};
+		// The most bits Save can use for this scope, used to reserve the bitset up front.
+		size_t CalculateMaxBinarySizeInBits() const;
+
+		void UpdateParentOfChildren();
+
+		const Scope* FindScope(std::string_view path) const;
+		const Variable* FindVariable(std::string_view path) const;
+
+		// Maps names to the position of the first child or variable with that name, using open addressing.
+		// Scopes with only a few of them are searched linearly instead. Whatever was added to the end is
+		// indexed on the next lookup, any other change needs to invalidate the index.
+		// Since it is updated during lookups, looking up in the same scope from multiple threads is not safe.
+		class NameIndex
+		{
+		public:
+			template<typename ElementType>
+			std::optional<size_t> Find(const std::vector<ElementType>& elements, const InternedString name);
+
+			inline void Invalidate() { mSlots.clear(); mNumOfIndexed = 0; }
+
+		private:
+			template<typename ElementType>
+			void Insert(const std::vector<ElementType>& elements, const size_t position);
+
+			static constexpr size_t sMinNumOfElementsToIndex = 8;
+
+			// 0 for empty slots, the position + 1 otherwise.
+			std::vector<uint32_t> mSlots{};
+			size_t mNumOfIndexed{};
+		};
+
+		InternedString mName{};
 		Scope* mParent{};
 		const Format mFormat{};
 
@@ -68,5 +113,7 @@ namespace Framework::Data
 		std::vector<Scope> mChildren{};
 		std::vector<Variable> mVariables{};
 
+		mutable NameIndex mChildIndex{};
+		mutable NameIndex mVariableIndex{};
 	};
 }
\ No newline at end of file
@@ -15,11 +15,22 @@
 #include "Texture.h"
 #include "Surface.h"
 #include "Settings.h"
+#include "JobSystem.h"
 
 Framework::Terrain::Terrain(Scene& scene) :
 	mScene(scene)
 {
 	Settings::Inst().mOnSettingsChanged.bind(this, &Terrain::OnSettingsChange);
+
+	// Changing this setting only takes effect once a new scene is loaded, the chunks are generated with or without a mesh.
+	Settings::Inst().GetSettings().GetVariable("GPU-based Terrain") >> mRenderFromHeightMap;
+
+	if (mRenderFromHeightMap)
+	{
+		glGenTextures(1, &mHeightMapTexture);
+		glGenTextures(1, &mNormalMapTexture);
+		glGenBuffers(1, &mPatchInstancesBuffer);
+	}
 }
 
 Framework::Terrain::~Terrain()
@@ -29,6 +40,14 @@ Framework::Terrain::~Terrain()
 		mScene.mPhysics->RemoveCollisionObjectFromWorld(std::move(mCollisionObject));
 	}
 
+	if (mRenderFromHeightMap)
+	{
+		glDeleteTextures(1, &mHeightMapTexture);
+		glDeleteTextures(1, &mNormalMapTexture);
+		glDeleteBuffers(1, &mPatchInstancesBuffer);
+		CheckGL();
+	}
+
 	Settings::Inst().mOnSettingsChanged.unbind(this, &Terrain::OnSettingsChange);
 }
 
@@ -70,19 +89,25 @@ float Framework::Terrain::GenerateTerrain(const uint maxNumOfChunksToGenerate)
 
 	const uint numOfChunksToMake = mData->mNumOfChunksX * mData->mNumOfChunksZ;
 
+	if (mNumOfChunksGenerated == 0
+		&& !mRenderFromHeightMap)
+	{
+		GenerateChunkMeshes();
+	}
+
 	uint chunkIndex = mNumOfChunksGenerated;
 	uint createdThisCycle = 0;
 
-	for (uint z = chunkIndex / mData->mNumOfChunksX; z < mData->mNumOfChunksZ && createdThisCycle < maxNumOfChunksToGenerate; z++)
+	for (; chunkIndex < numOfChunksToMake && createdThisCycle < maxNumOfChunksToGenerate; chunkIndex++, createdThisCycle++)
 	{
-		for (uint x = chunkIndex % mData->mNumOfChunksX; x < mData->mNumOfChunksX && createdThisCycle < maxNumOfChunksToGenerate; x++, chunkIndex++, createdThisCycle++)
-		{
-			glm::vec2 chunkPosition = { static_cast<float>(static_cast<float>(x) * Chunk::sSizeX),
-				static_cast<float>(static_cast<float>(z) * Chunk::sSizeZ) };
-			chunkPosition += glm::vec2{ Chunk::sSizeX, Chunk::sSizeZ } *0.5f;
+		std::optional<Chunk::MeshData> generatedMesh{};
 
-			mScene.mEntityManager->AddEntity<Chunk>(chunkPosition);
+		if (!mChunkVertexArena.empty())
+		{
+			generatedMesh = GetGeneratedChunkMesh(chunkIndex);
 		}
+
+		mScene.mEntityManager->AddEntity<Chunk>(CalculateChunkPosition(chunkIndex), generatedMesh);
 	}
 
 	mNumOfChunksGenerated += createdThisCycle;
@@ -90,20 +115,34 @@ float Framework::Terrain::GenerateTerrain(const uint maxNumOfChunksToGenerate)
 	const uint amountLeft = numOfChunksToMake - chunkIndex;
 	if (amountLeft == 0)
 	{
+		// Everything has been uploaded, free the arena.
+		mChunkVertexArena = {};
+		mChunkNormalArena = {};
+		mChunkUVArena = {};
+
 		SendTerrainToPhysics();
+
+		if (mRenderFromHeightMap)
+		{
+			SendTerrainToGPU();
+		}
 	}
 
 	const float percentageGenerated = static_cast<float>(chunkIndex) / static_cast<float>(numOfChunksToMake);
 	return percentageGenerated;
 }
 
-void Framework::Terrain::Serialize(Framework::Data::Scope& parentScope) const
+void Framework::Terrain::Serialize(Framework::Data::Scope& parentScope, const bool includeHeightMap) const
 {
 	Data::Scope& myScope = parentScope.AddChild("Terrain");
 
 	myScope.AddVariable("numOfChunksX") << mData->mNumOfChunksX;
 	myScope.AddVariable("numOfChunksZ") << mData->mNumOfChunksZ;
-	myScope.AddVariable("heightMap") << mData->GetHeightMap();
+	myScope.AddVariable("heightMapHash") << mData->GetHeightMapHash();
+	if (includeHeightMap)
+	{
+		myScope.AddVariable("heightMap") << mData->GetHeightMap();
+	}
 	myScope.AddVariable("seedNonRepeatTexture") << mSeedForNonRepeatTexture;
 }
 
@@ -143,6 +182,88 @@ void Framework::Terrain::OnSettingsChange(const Data::Scope& previousSettings, c
 	}
 }
 
+void Framework::Terrain::DrawRequestedPatches(const Camera& camera)
+{
+	if (mPatchRequests.empty())
+	{
+		return;
+	}
+
+	assert(mPatchMesh != nullptr);
+
+	const MyShader* shader = mPatchMesh->GetShader();
+	shader->Bind();
+
+	shader->SetInputTexture(2, "flatSampler", *mPatchMesh->GetMaterial()->GetDiffuse());
+	shader->SetInputTexture(3, "steepSampler", *mPatchMesh->GetMaterial()->GetAlpha());
+	shader->SetInputTexture(4, "heightSampler", mHeightMapTexture);
+	shader->SetInputTexture(5, "normalSampler", mNormalMapTexture);
+	shader->SetInt("sampleHeightMap", TRUE);
+	shader->SetFloat("spaceBetweenVertices", Chunk::sSpaceBetweenVertices);
+
+	// The patches are already placed in world space by the vertex shader.
+	shader->SetInputMatrix("MVP", camera.GetViewProjection());
+	shader->SetInputMatrix("modelMatrix", glm::mat4{ 1.0f });
+	shader->SetFloat3("cameraPos", camera.GetTransform().GetLocalPosition());
+
+	glBindVertexArray(mPatchMesh->GetVertexArrayObject());
+
+	glBindBuffer(GL_ARRAY_BUFFER, mPatchInstancesBuffer);
+	glBufferData(GL_ARRAY_BUFFER, mPatchRequests.size() * sizeof(glm::vec2), &mPatchRequests[0], GL_STREAM_DRAW);
+
+	glEnableVertexAttribArray(3);
+	glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+	glVertexAttribDivisor(3, 1);
+
+	glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(mPatchMesh->GetNumOfTriangles() * 3u), GL_UNSIGNED_SHORT, 0, static_cast<GLsizei>(mPatchRequests.size()));
+
+	glBindVertexArray(0);
+
+	// The same shader is used for chunks with their own mesh.
+	shader->SetInt("sampleHeightMap", FALSE);
+	shader->Unbind();
+
+	mPatchRequests.clear();
+	CheckGL();
+}
+
+glm::vec2 Framework::Terrain::CalculateChunkPosition(const uint chunkIndex) const
+{
+	const uint x = chunkIndex % mData->mNumOfChunksX;
+	const uint z = chunkIndex / mData->mNumOfChunksX;
+
+	glm::vec2 chunkPosition = { static_cast<float>(static_cast<float>(x) * Chunk::sSizeX),
+		static_cast<float>(static_cast<float>(z) * Chunk::sSizeZ) };
+	chunkPosition += glm::vec2{ Chunk::sSizeX, Chunk::sSizeZ } *0.5f;
+
+	return chunkPosition;
+}
+
+void Framework::Terrain::GenerateChunkMeshes()
+{
+	const size_t numOfChunks = static_cast<size_t>(mData->mNumOfChunksX) * static_cast<size_t>(mData->mNumOfChunksZ);
+	const size_t numOfVertices = numOfChunks * Chunk::sNumOfVertices;
+
+	mChunkVertexArena.resize(numOfVertices);
+	mChunkNormalArena.resize(numOfVertices);
+	mChunkUVArena.resize(numOfVertices);
+
+	JobSystem::Inst().ParallelFor(numOfChunks, 
+		[this](const size_t chunkIndex)
+		{
+			const uint index = static_cast<uint>(chunkIndex);
+			Chunk::GenerateMeshData(CalculateChunkPosition(index), *mData, GetGeneratedChunkMesh(index));
+		});
+}
+
+Framework::Chunk::MeshData Framework::Terrain::GetGeneratedChunkMesh(const uint chunkIndex)
+{
+	const size_t firstVertex = static_cast<size_t>(chunkIndex) * Chunk::sNumOfVertices;
+	assert(firstVertex + Chunk::sNumOfVertices <= mChunkVertexArena.size());
+
+	return { &mChunkVertexArena[firstVertex], &mChunkNormalArena[firstVertex], &mChunkUVArena[firstVertex] };
+}
+
 void Framework::Terrain::SendTerrainToPhysics()
 {
 	if (mCollisionObject != nullptr)
@@ -177,4 +298,30 @@ void Framework::Terrain::SendTerrainToPhysics()
 
 	mCollisionObject = std::make_unique<btCollisionObject>(std::move(object));
 	mScene.mPhysics->AddCollisionObjectToWorld(mCollisionObject.get(), Framework::Physics::Group::terrainGroup, Framework::Physics::Mask::terrainMask);
+}
+
+void Framework::Terrain::SendTerrainToGPU()
+{
+	mPatchMesh = Chunk::GeneratePatchMesh();
+
+	const GLsizei width = static_cast<GLsizei>(mData->mNumOfVerticesX);
+	const GLsizei height = static_cast<GLsizei>(mData->mNumOfVerticesZ);
+
+	// Each vertex of the patch lines up exactly with a sample, so texelFetch is used and no filtering is needed.
+	glBindTexture(GL_TEXTURE_2D, mHeightMapTexture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, width, height, 0, GL_RED, GL_FLOAT, &mData->GetHeightMap()[0]);
+
+	glBindTexture(GL_TEXTURE_2D, mNormalMapTexture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, width, height, 0, GL_RGB, GL_FLOAT, &mData->GetNormals()[0]);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	CheckGL();
 }
\ No newline at end of file
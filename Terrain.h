@@ -12,6 +12,8 @@ namespace Framework
 	}
 
 	class Scene;
+	class Mesh;
+	class Camera;
 
 	class Terrain
 	{
@@ -35,13 +37,27 @@ namespace Framework
 		// Returns the percentage of chunks that have been generated.
 		float GenerateTerrain(const uint maxNumOfChunksToGenerate = std::numeric_limits<uint>::max());
 		
-		void Serialize(Framework::Data::Scope& parentScope) const;
+		// Without the heightmap, only its hash is stored. Used by delta saves, which get the heightmap from their keyframe.
+		void Serialize(Framework::Data::Scope& parentScope, const bool includeHeightMap = true) const;
 		void Deserialize(const Framework::Data::Scope& parentScope);
 
 		void OnSettingsChange(const Data::Scope& previousSettings, const Data::Scope& currentSettings);
 
+		// When rendering from the heightmap, chunks don't generate their own mesh. Instead, the visible chunks request 
+		// a patch to be drawn at their position, and all the requested patches are drawn in a single instanced call.
+		inline bool IsRenderedFromHeightMap() const { return mRenderFromHeightMap; }
+		inline void RequestPatchDraw(const glm::vec2 chunkPosition) { mPatchRequests.push_back(chunkPosition); }
+		void DrawRequestedPatches(const Camera& camera);
+
 	private:
 		void SendTerrainToPhysics();
+		void SendTerrainToGPU();
+
+		glm::vec2 CalculateChunkPosition(const uint chunkIndex) const;
+
+		// Generates the meshes of all the chunks into the arena, using all the cores.
+		void GenerateChunkMeshes();
+		Chunk::MeshData GetGeneratedChunkMesh(const uint chunkIndex);
 
 		std::unique_ptr<btHeightfieldTerrainShape> mCollisionShape{};
 		std::unique_ptr<btCollisionObject> mCollisionObject{};
@@ -50,6 +66,20 @@ namespace Framework
 		std::unique_ptr<TerrainData> mData{};
 
 		uint mNumOfChunksGenerated{};
+
+		// The meshes of all the chunks, stored back to back. They are generated up front on worker threads, 
+		// after which the chunks are created and uploaded to the GPU on the main thread bit by bit.
+		std::vector<glm::vec3> mChunkVertexArena{};
+		std::vector<glm::vec3> mChunkNormalArena{};
+		std::vector<glm::vec2> mChunkUVArena{};
 		uint mSeedForNonRepeatTexture{};
+
+		bool mRenderFromHeightMap{};
+		std::unique_ptr<Mesh> mPatchMesh{};
+		std::vector<glm::vec2> mPatchRequests{};
+
+		GLuint mHeightMapTexture{};
+		GLuint mNormalMapTexture{};
+		GLuint mPatchInstancesBuffer{};
 	};
 }
\ No newline at end of file
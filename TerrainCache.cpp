@@ -0,0 +1,132 @@
+#include "precomp.h"
+#include "TerrainCache.h"
+
+#include <filesystem>
+
+#include "TerrainData.h"
+#include "MappedFile.h"
+
+// Every array starts on an aligned offset, so they can be read straight from the mapped file.
+static constexpr uint64_t sAlignment = 16;
+
+static uint64_t Align(const uint64_t offset)
+{
+	return (offset + sAlignment - 1) / sAlignment * sAlignment;
+}
+
+// Written so that a corrupted offset or count cannot overflow.
+template<typename T>
+static bool IsArrayInFile(const Framework::MappedFile& file, const uint64_t offset, const uint64_t count)
+{
+	return offset <= file.GetSize()
+		&& count <= (file.GetSize() - offset) / sizeof(T);
+}
+
+template<typename T>
+static std::vector<T> ReadArray(const Framework::MappedFile& file, const uint64_t offset, const size_t count)
+{
+	const T* first = reinterpret_cast<const T*>(file.GetData() + offset);
+	return std::vector<T>(first, first + count);
+}
+
+template<typename T>
+static void WriteArray(std::ofstream& file, const uint64_t offset, const std::vector<T>& data)
+{
+	file.seekp(static_cast<std::streamoff>(offset));
+	file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(T)));
+}
+
+bool Framework::TerrainCache::Load(const uint64_t key, TerrainData& terrainData)
+{
+	const MappedFile file(GetFilePath(key));
+
+	if (!file.IsOpen()
+		|| file.GetSize() < sizeof(Header))
+	{
+		return false;
+	}
+
+	Header header{};
+	memcpy(&header, file.GetData(), sizeof(Header));
+
+	const size_t numOfVertices = static_cast<size_t>(terrainData.mNumOfVerticesX) * static_cast<size_t>(terrainData.mNumOfVerticesZ);
+
+	if (header.mMagic != sMagic
+		|| header.mVersion != sVersion
+		|| header.mKey != key
+		|| header.mNumOfVerticesX != terrainData.mNumOfVerticesX
+		|| header.mNumOfVerticesZ != terrainData.mNumOfVerticesZ
+		|| header.mNumOfPyramidCells != terrainData.CalculateNumOfPyramidCells()
+		|| !IsArrayInFile<float>(file, header.mHeightMapOffset, numOfVertices)
+		|| !IsArrayInFile<glm::vec3>(file, header.mNormalsOffset, numOfVertices)
+		|| !IsArrayInFile<glm::vec2>(file, header.mPyramidOffset, header.mNumOfPyramidCells))
+	{
+		LOGWARNING("Terrain cache " << GetFilePath(key) << " is outdated or corrupted, the terrain will be generated instead");
+		return false;
+	}
+
+	terrainData.SetPrecalculatedHeightMap(
+		ReadArray<float>(file, header.mHeightMapOffset, numOfVertices),
+		ReadArray<glm::vec3>(file, header.mNormalsOffset, numOfVertices),
+		ReadArray<glm::vec2>(file, header.mPyramidOffset, static_cast<size_t>(header.mNumOfPyramidCells)));
+
+	return true;
+}
+
+void Framework::TerrainCache::Save(const uint64_t key, const TerrainData& terrainData)
+{
+	const std::vector<float>& heightMap = terrainData.GetHeightMap();
+	const std::vector<glm::vec3>& normals = terrainData.GetNormals();
+	const std::vector<glm::vec2>& pyramid = terrainData.GetMinMaxPyramid();
+
+	Header header{};
+	header.mMagic = sMagic;
+	header.mVersion = sVersion;
+	header.mKey = key;
+	header.mNumOfVerticesX = terrainData.mNumOfVerticesX;
+	header.mNumOfVerticesZ = terrainData.mNumOfVerticesZ;
+	header.mNumOfPyramidCells = pyramid.size();
+	header.mHeightMapOffset = Align(sizeof(Header));
+	header.mNormalsOffset = Align(header.mHeightMapOffset + heightMap.size() * sizeof(float));
+	header.mPyramidOffset = Align(header.mNormalsOffset + normals.size() * sizeof(glm::vec3));
+
+	const std::string filePath = GetFilePath(key);
+	std::error_code error{};
+	std::filesystem::create_directories(std::filesystem::path(filePath).parent_path(), error);
+
+	// Written to a temporary file first, so a crash while saving never leaves behind a half written cache.
+	const std::string temporaryFilePath = filePath + ".tmp";
+	{
+		std::ofstream file(temporaryFilePath, std::ios::binary | std::ios::trunc);
+
+		if (!file.is_open())
+		{
+			LOGWARNING("Could not create terrain cache " << filePath);
+			return;
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		WriteArray(file, header.mHeightMapOffset, heightMap);
+		WriteArray(file, header.mNormalsOffset, normals);
+		WriteArray(file, header.mPyramidOffset, pyramid);
+
+		if (!file.good())
+		{
+			LOGWARNING("Failed to write terrain cache " << filePath);
+			return;
+		}
+	}
+
+	std::filesystem::rename(temporaryFilePath, filePath, error);
+	if (error)
+	{
+		LOGWARNING("Could not move terrain cache into place: " << error.message());
+	}
+}
+
+std::string Framework::TerrainCache::GetFilePath(const uint64_t key)
+{
+	std::stringstream fileName{};
+	fileName << sDataRoot << "cache/terrain_" << std::hex << key << ".bin";
+	return fileName.str();
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+namespace Framework
+{
+	class TerrainData;
+
+	// Stores generated terrain on disk, so the same terrain does not have to be generated again the next time.
+	// The file is a header followed by the raw arrays, so it can be memory mapped and copied straight into the terrain.
+	class TerrainCache
+	{
+	public:
+		// Every generation parameter is appended to the key, the same parameters always produce the same key.
+		template<typename T>
+		static inline uint64_t AppendToKey(const uint64_t key, const T& parameter);
+		static constexpr uint64_t sEmptyKey = Math::sEmptyHash;
+
+		// Returns false if there was no cache for this key, the terrain data is left untouched in that case.
+		static bool Load(const uint64_t key, TerrainData& terrainData);
+		static void Save(const uint64_t key, const TerrainData& terrainData);
+
+	private:
+		static std::string GetFilePath(const uint64_t key);
+
+		// Increase this whenever the generation or the layout of the file changes, to invalidate the existing caches.
+		static constexpr uint32_t sVersion = 1;
+		static constexpr uint32_t sMagic = 0x43525254; // "TRRC"
+
+		struct Header
+		{
+			uint32_t mMagic{};
+			uint32_t mVersion{};
+			uint64_t mKey{};
+
+			uint32_t mNumOfVerticesX{};
+			uint32_t mNumOfVerticesZ{};
+			uint64_t mNumOfPyramidCells{};
+
+			// In bytes, from the start of the file.
+			uint64_t mHeightMapOffset{};
+			uint64_t mNormalsOffset{};
+			uint64_t mPyramidOffset{};
+		};
+	};
+
+	template<typename T>
+	inline uint64_t TerrainCache::AppendToKey(const uint64_t key, const T& parameter)
+	{
+		return Math::Hash(parameter, key);
+	}
+}
\ No newline at end of file
@@ -105,12 +105,65 @@ void Framework::TerrainData::SetHeightMap(std::vector<float> heightMap)
 		height -= lowestHeight;
 	}
 
-	mHeightestVertexHeight = *std::max_element(mHeightMap.begin(), mHeightMap.end());
+	RecalculateNormals();
+	RecalculateMinMaxPyramid();
+	OnHeightMapChanged();
+}
+
+void Framework::TerrainData::SetPrecalculatedHeightMap(std::vector<float> heightMap, std::vector<glm::vec3> normals, std::vector<glm::vec2> minMaxPyramid)
+{
+	assert(heightMap.size() == mNumOfVerticesX * mNumOfVerticesZ);
+	assert(normals.size() == heightMap.size());
+
+	mHeightMap = std::move(heightMap);
+	mNormals = std::move(normals);
+
+	// Only the layout of the pyramid is calculated, the values themselves come from the cache.
+	CalculatePyramidLevelOffsets();
+	assert(minMaxPyramid.size() == mMinMaxPyramid.size());
+	mMinMaxPyramid = std::move(minMaxPyramid);
+
+	OnHeightMapChanged();
+}
+
+uint64_t Framework::TerrainData::GetHeightMapHash() const
+{
+	if (!mHeightMapHash.has_value())
+	{
+		mHeightMapHash = Math::HashBytes(mHeightMap.data(), mHeightMap.size() * sizeof(float));
+	}
+	return mHeightMapHash.value();
+}
+
+void Framework::TerrainData::OnHeightMapChanged()
+{
+	mHeightMapHash.reset();
+
+	// The top of the pyramid covers the entire terrain.
+	mHeightestVertexHeight = mMinMaxPyramid.back().y;
 
 	btVector3 halfExtends = { Chunk::sSizeX * 0.5f, mHeightestVertexHeight * .5f, Chunk::sSizeZ * 0.5f };
 	mChunkBoxShape = std::make_unique<btBoxShape>(halfExtends);
+}
 
-	RecalculateNormals();
+glm::uvec2 Framework::TerrainData::GetPyramidLevelSize(const uint level) const
+{
+	assert(level < GetNumOfPyramidLevels());
+
+	glm::uvec2 size = { mNumOfChunksX, mNumOfChunksZ };
+	for (uint i = 0; i < level; i++)
+	{
+		size = (size + 1u) / 2u;
+	}
+	return size;
+}
+
+glm::vec2 Framework::TerrainData::GetMinMaxHeight(const uint level, const uint cellX, const uint cellZ) const
+{
+	const glm::uvec2 levelSize = GetPyramidLevelSize(level);
+	assert(cellX < levelSize.x
+		&& cellZ < levelSize.y);
+	return mMinMaxPyramid[mPyramidLevelOffsets[level] + cellX + cellZ * levelSize.x];
 }
 
 void Framework::TerrainData::RecalculateNormals()
@@ -137,4 +190,105 @@ void Framework::TerrainData::RecalculateNormals()
 			mNormals[vertexIndex] = normalize(glm::vec3((fx0 - fx1) / (2 * eps), 1, (fy0 - fy1) / (2 * eps)));
 		}
 	}
+}
+
+void Framework::TerrainData::CalculatePyramidLevelOffsets()
+{
+	mPyramidLevelOffsets.clear();
+
+	size_t offset = 0;
+	glm::uvec2 size = { mNumOfChunksX, mNumOfChunksZ };
+
+	while (true)
+	{
+		mPyramidLevelOffsets.push_back(offset);
+		offset += static_cast<size_t>(size.x) * static_cast<size_t>(size.y);
+
+		if (size.x <= 1u
+			&& size.y <= 1u)
+		{
+			break;
+		}
+		size = (size + 1u) / 2u;
+	}
+
+	mMinMaxPyramid.resize(offset);
+}
+
+size_t Framework::TerrainData::CalculateNumOfPyramidCells() const
+{
+	size_t numOfCells = 0;
+	glm::uvec2 size = { mNumOfChunksX, mNumOfChunksZ };
+
+	while (true)
+	{
+		numOfCells += static_cast<size_t>(size.x) * static_cast<size_t>(size.y);
+
+		if (size.x <= 1u
+			&& size.y <= 1u)
+		{
+			return numOfCells;
+		}
+		size = (size + 1u) / 2u;
+	}
+}
+
+void Framework::TerrainData::RecalculateMinMaxPyramid()
+{
+	CalculatePyramidLevelOffsets();
+
+	constexpr uint numOfCellsPerChunkX = Chunk::sNumOfVerticesX - 1u;
+	constexpr uint numOfCellsPerChunkZ = Chunk::sNumOfVerticesZ - 1u;
+
+	// The vertices on the border between two chunks belong to both.
+	for (uint chunkZ = 0; chunkZ < mNumOfChunksZ; chunkZ++)
+	{
+		for (uint chunkX = 0; chunkX < mNumOfChunksX; chunkX++)
+		{
+			glm::vec2 minMax = { std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest() };
+
+			const uint endZ = std::min((chunkZ + 1u) * numOfCellsPerChunkZ + 1u, mNumOfVerticesZ);
+			const uint endX = std::min((chunkX + 1u) * numOfCellsPerChunkX + 1u, mNumOfVerticesX);
+
+			for (uint z = chunkZ * numOfCellsPerChunkZ; z < endZ; z++)
+			{
+				for (uint x = chunkX * numOfCellsPerChunkX; x < endX; x++)
+				{
+					const float height = mHeightMap[x + z * mNumOfVerticesX];
+					minMax.x = std::min(minMax.x, height);
+					minMax.y = std::max(minMax.y, height);
+				}
+			}
+
+			mMinMaxPyramid[chunkX + chunkZ * mNumOfChunksX] = minMax;
+		}
+	}
+
+	for (uint level = 1; level < GetNumOfPyramidLevels(); level++)
+	{
+		const glm::uvec2 previousSize = GetPyramidLevelSize(level - 1u);
+		const glm::uvec2 size = GetPyramidLevelSize(level);
+		const size_t previousOffset = mPyramidLevelOffsets[level - 1u];
+
+		for (uint z = 0; z < size.y; z++)
+		{
+			for (uint x = 0; x < size.x; x++)
+			{
+				glm::vec2 minMax = { std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest() };
+
+				// When the level below has an odd size, the cells on the far edge only cover a single row or column.
+				for (uint previousZ = z * 2u; previousZ < std::min(z * 2u + 2u, previousSize.y); previousZ++)
+				{
+					for (uint previousX = x * 2u; previousX < std::min(x * 2u + 2u, previousSize.x); previousX++)
+					{
+						const glm::vec2 previous = mMinMaxPyramid[previousOffset + previousX + previousZ * previousSize.x];
+						minMax.x = std::min(minMax.x, previous.x);
+						minMax.y = std::max(minMax.y, previous.y);
+					}
+				}
+
+				mMinMaxPyramid[mPyramidLevelOffsets[level] + x + z * size.x] = minMax;
+			}
+		}
+	}
 }
\ No newline at end of file
@@ -14,6 +14,9 @@ namespace Framework
 		inline const std::vector<float>& GetHeightMap() const { return mHeightMap; }
 		inline const std::vector<glm::vec3>& GetNormals() const { return mNormals; }
 
+		// Calculated the first time it is needed after the heightmap changed.
+		uint64_t GetHeightMapHash() const;
+
 		float GetHeightAtPositionFast(const float x, const float z) const;
 
 		float GetHeightAtPosition(const float x, const float z) const;
@@ -26,6 +29,13 @@ namespace Framework
 
 		float GetHeighestVertexHeight() const { return mHeightestVertexHeight; }
 
+		// The lowest (x) and highest (y) height within each chunk make up level 0 of the pyramid, every level 
+		// above that combines 2x2 cells of the level below, up until a single cell that covers the whole terrain.
+		inline uint GetNumOfPyramidLevels() const { return static_cast<uint>(mPyramidLevelOffsets.size()); }
+		glm::uvec2 GetPyramidLevelSize(const uint level) const;
+		glm::vec2 GetMinMaxHeight(const uint level, const uint cellX, const uint cellZ) const;
+		inline const std::vector<glm::vec2>& GetMinMaxPyramid() const { return mMinMaxPyramid; }
+
 		template<typename T>
 		inline T BilinearInterpolation(const std::vector<T>& data, const float x, const float z) const;
 
@@ -48,11 +58,25 @@ namespace Framework
 		void SetHeightMap(std::vector<float> heightMap);
 
 	private:
+		// Skips the normalizing of the heights and the calculation of the normals and pyramid, they were done when the cache was made.
+		friend class TerrainCache;
+		void SetPrecalculatedHeightMap(std::vector<float> heightMap, std::vector<glm::vec3> normals, std::vector<glm::vec2> minMaxPyramid);
+
+		void OnHeightMapChanged();
 		void RecalculateNormals();
+		void CalculatePyramidLevelOffsets();
+		size_t CalculateNumOfPyramidCells() const;
+		void RecalculateMinMaxPyramid();
 
 		std::vector<glm::vec3> mNormals{};
 		std::vector<float> mHeightMap{};
 
+		// All levels stored back to back, starting with the per-chunk level.
+		std::vector<glm::vec2> mMinMaxPyramid{};
+		std::vector<size_t> mPyramidLevelOffsets{};
+
 		float mHeightestVertexHeight{};
+
+		mutable std::optional<uint64_t> mHeightMapHash{};
 	};
 }
\ No newline at end of file
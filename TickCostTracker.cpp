@@ -0,0 +1,325 @@
+#include "precomp.h"
+#include "TickCostTracker.h"
+
+#include <filesystem>
+#include <iomanip>
+#ifndef _MSC_VER
+#include <cxxabi.h>
+#endif // !_MSC_VER
+
+#include "Settings.h"
+#include "Scope.h"
+
+Framework::TickCostTracker::TickCostTracker()
+{
+	const std::optional<const Data::Scope*> budgetsScope = Settings::Inst().GetSettings().TryGetScope("tickBudgets");
+
+	if (budgetsScope.has_value())
+	{
+		for (const Data::Variable& budgetVar : (*budgetsScope)->GetVariables())
+		{
+			float budget{};
+			budgetVar >> budget;
+			mBudgets[budgetVar.GetName()] = budget;
+		}
+	}
+
+	mTotalCosts = CreateTypeCosts("Total");
+
+	Settings::Inst().GetSettings().GetVariable("trackTickCosts") >> mIsEnabled;
+	mIsEnabled |= sIsWindowOpen;
+}
+
+void Framework::TickCostTracker::AddTick(const std::type_index type, const Clock::duration duration, const AllocationTracker::Counters& allocations)
+{
+	if (mLastType != type)
+	{
+		auto it = mCostsPerType.find(type);
+
+		if (it == mCostsPerType.end())
+		{
+			it = mCostsPerType.emplace(type, CreateTypeCosts(GetReadableName(type))).first;
+		}
+
+		mLastType = type;
+		mLastTypeCosts = &it->second;
+	}
+
+	TypeCosts& costs = *mLastTypeCosts;
+	costs.mDurationThisFrame += duration;
+	++costs.mNumOfTicksThisFrame;
+	costs.mAllocationsThisFrame += allocations;
+
+	mTotalCosts.mDurationThisFrame += duration;
+	++mTotalCosts.mNumOfTicksThisFrame;
+	mTotalCosts.mAllocationsThisFrame += allocations;
+}
+
+void Framework::TickCostTracker::EndFrame()
+{
+	if (!mIsEnabled)
+	{
+		return;
+	}
+
+	for (auto& [type, costs] : mCostsPerType)
+	{
+		EndFrame(costs);
+	}
+
+	EndFrame(mTotalCosts);
+}
+
+void Framework::TickCostTracker::EndFrame(TypeCosts& costs)
+{
+	const float duration = std::chrono::duration<float, std::milli>(costs.mDurationThisFrame).count();
+
+	const size_t frameIndex = static_cast<size_t>(costs.mNumOfFramesRecorded % sNumOfFramesKept);
+	costs.mFrameDurations[frameIndex] = duration;
+	costs.mFrameNumOfTicks[frameIndex] = costs.mNumOfTicksThisFrame;
+	costs.mFrameAllocations[frameIndex] = costs.mAllocationsThisFrame;
+	++costs.mNumOfFramesRecorded;
+
+	costs.mDurationThisFrame = {};
+	costs.mNumOfTicksThisFrame = 0;
+	costs.mAllocationsThisFrame = {};
+
+	if (!costs.mBudget.has_value()
+		|| duration <= *costs.mBudget)
+	{
+		return;
+	}
+
+	++costs.mNumOfFramesOverBudget;
+	++costs.mNumOfFramesOverBudgetSinceWarning;
+
+	// Once a type goes over its budget it usually stays over it for a while, so the warnings are spread out.
+	const Clock::time_point now = Clock::now();
+	if (costs.mLastWarning.has_value()
+		&& std::chrono::duration<float>(now - *costs.mLastWarning).count() < sSecondsBetweenWarnings)
+	{
+		return;
+	}
+
+	LOGWARNING(costs.mName << " took " << duration << " ms to tick, its budget is " << *costs.mBudget << " ms. Went over budget " << costs.mNumOfFramesOverBudgetSinceWarning << " time(s) since the last warning.");
+
+	costs.mLastWarning = now;
+	costs.mNumOfFramesOverBudgetSinceWarning = 0;
+}
+
+Framework::TickCostTracker::TypeCosts Framework::TickCostTracker::CreateTypeCosts(const std::string& name) const
+{
+	TypeCosts costs{};
+	costs.mName = name;
+
+	const auto budget = mBudgets.find(name);
+
+	if (budget != mBudgets.end())
+	{
+		costs.mBudget = budget->second;
+	}
+
+	return costs;
+}
+
+Framework::TickCostTracker::Statistics Framework::TickCostTracker::CalculateStatistics(const TypeCosts& costs)
+{
+	Statistics statistics{};
+
+	const size_t numOfFrames = static_cast<size_t>(std::min<uint64_t>(costs.mNumOfFramesRecorded, sNumOfFramesKept));
+
+	if (numOfFrames == 0)
+	{
+		return statistics;
+	}
+
+	std::vector<float> durations(costs.mFrameDurations.begin(), costs.mFrameDurations.begin() + numOfFrames);
+	std::sort(durations.begin(), durations.end());
+
+	const auto percentile = [&durations](const float fraction)
+		{
+			return durations[std::min(static_cast<size_t>(fraction * static_cast<float>(durations.size())), durations.size() - 1)];
+		};
+
+	for (const float duration : durations)
+	{
+		statistics.mMean += duration;
+	}
+	statistics.mMean /= static_cast<float>(numOfFrames);
+
+	statistics.mP50 = percentile(0.5f);
+	statistics.mP95 = percentile(0.95f);
+	statistics.mP99 = percentile(0.99f);
+	statistics.mMax = durations.back();
+
+	// Over the same frames as the durations, which frames those are does not matter for a sum.
+	uint64_t numOfTicks{};
+	AllocationTracker::Counters allocations{};
+
+	for (size_t i = 0; i < numOfFrames; i++)
+	{
+		numOfTicks += costs.mFrameNumOfTicks[i];
+		allocations += costs.mFrameAllocations[i];
+	}
+
+	statistics.mTicksPerFrame = static_cast<float>(numOfTicks) / static_cast<float>(numOfFrames);
+	statistics.mAllocationsPerFrame = static_cast<float>(allocations.mNumOfAllocations) / static_cast<float>(numOfFrames);
+	statistics.mBytesAllocatedPerFrame = static_cast<float>(allocations.mNumOfBytesAllocated) / static_cast<float>(numOfFrames);
+
+	return statistics;
+}
+
+std::string Framework::TickCostTracker::GetReadableName(const std::type_index type)
+{
+	std::string name = type.name();
+
+#ifndef _MSC_VER
+	int status{};
+	char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+
+	if (status == 0)
+	{
+		name = demangled;
+	}
+	std::free(demangled);
+#endif // !_MSC_VER
+
+	const size_t namespaceEnd = name.rfind("::");
+	if (namespaceEnd != std::string::npos)
+	{
+		return name.substr(namespaceEnd + 2);
+	}
+
+	// MSVC puts "class " or "struct " in front of types that are not in a namespace.
+	const size_t keywordEnd = name.rfind(' ');
+	if (keywordEnd != std::string::npos)
+	{
+		return name.substr(keywordEnd + 1);
+	}
+
+	return name;
+}
+
+void Framework::TickCostTracker::DrawImGui() const
+{
+	if (!sIsWindowOpen)
+	{
+		return;
+	}
+
+	ImGui::SetNextWindowSize({ 700.0f, 250.0f }, ImGuiCond_FirstUseEver);
+	if (ImGui::Begin("Tick costs", &sIsWindowOpen))
+	{
+		ImGui::Text("In milliseconds per frame, over the last %u frames.", sNumOfFramesKept);
+
+		if (ImGui::BeginTable("TickCosts", AllocationTracker::IsEnabled() ? 9 : 8, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp))
+		{
+			ImGui::TableSetupColumn("Type");
+			ImGui::TableSetupColumn("Ticks");
+			ImGui::TableSetupColumn("Mean");
+			ImGui::TableSetupColumn("P50");
+			ImGui::TableSetupColumn("P95");
+			ImGui::TableSetupColumn("P99");
+			ImGui::TableSetupColumn("Max");
+			ImGui::TableSetupColumn("Budget");
+			if (AllocationTracker::IsEnabled())
+			{
+				ImGui::TableSetupColumn("Allocations");
+			}
+			ImGui::TableHeadersRow();
+
+			const auto drawRow = [](const TypeCosts& costs)
+				{
+					const Statistics statistics = CalculateStatistics(costs);
+
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(costs.mName.c_str());
+					ImGui::TableNextColumn();
+					ImGui::Text("%.1f", statistics.mTicksPerFrame);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", statistics.mMean);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", statistics.mP50);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", statistics.mP95);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", statistics.mP99);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", statistics.mMax);
+					ImGui::TableNextColumn();
+
+					if (costs.mBudget.has_value())
+					{
+						const bool isOverBudget = statistics.mP95 > *costs.mBudget;
+						ImGui::TextColored(isOverBudget ? ImVec4{ 1.0f, 0.3f, 0.3f, 1.0f } : ImVec4{ 1.0f, 1.0f, 1.0f, 1.0f }, "%.3f (%llu over)", *costs.mBudget, static_cast<unsigned long long>(costs.mNumOfFramesOverBudget));
+					}
+					else
+					{
+						ImGui::Text("-");
+					}
+
+					if (AllocationTracker::IsEnabled())
+					{
+						ImGui::TableNextColumn();
+						ImGui::Text("%.1f (%.0f bytes)", statistics.mAllocationsPerFrame, statistics.mBytesAllocatedPerFrame);
+					}
+				};
+
+			for (const auto& [type, costs] : mCostsPerType)
+			{
+				drawRow(costs);
+			}
+			drawRow(mTotalCosts);
+
+			ImGui::EndTable();
+		}
+	}
+	ImGui::End();
+}
+
+bool Framework::TickCostTracker::Dump(const std::string& filePath) const
+{
+	const std::string fullPath = sDataRoot + filePath;
+	std::error_code error{};
+	std::filesystem::create_directories(std::filesystem::path(fullPath).parent_path(), error);
+
+	std::ofstream file(fullPath, std::ios::trunc);
+
+	if (!file.is_open())
+	{
+		LOGWARNING("Could not create tick cost dump " << filePath);
+		return false;
+	}
+
+	file << std::fixed << std::setprecision(4);
+	file << "type,frames,ticksPerFrame,meanMs,p50Ms,p95Ms,p99Ms,maxMs,budgetMs,framesOverBudget,allocationsPerFrame,bytesAllocatedPerFrame\n";
+
+	const auto writeRow = [&file](const TypeCosts& costs)
+		{
+			const Statistics statistics = CalculateStatistics(costs);
+
+			file << costs.mName << ',' << costs.mNumOfFramesRecorded << ',' << statistics.mTicksPerFrame << ',' << statistics.mMean << ',' << statistics.mP50
+				<< ',' << statistics.mP95 << ',' << statistics.mP99 << ',' << statistics.mMax << ',';
+
+			if (costs.mBudget.has_value())
+			{
+				file << *costs.mBudget;
+			}
+
+			file << ',' << costs.mNumOfFramesOverBudget << ',' << statistics.mAllocationsPerFrame << ',' << statistics.mBytesAllocatedPerFrame << '\n';
+		};
+
+	for (const auto& [type, costs] : mCostsPerType)
+	{
+		writeRow(costs);
+	}
+	writeRow(mTotalCosts);
+
+	if (!file.good())
+	{
+		LOGWARNING("Failed to write tick cost dump " << filePath);
+		return false;
+	}
+	return true;
+}
\ No newline at end of file
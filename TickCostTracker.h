@@ -0,0 +1,92 @@
+#pragma once
+#include <chrono>
+#include <typeindex>
+
+#include "AllocationTracker.h"
+
+namespace Framework
+{
+	// Keeps track of how long the entities of each type take to tick, per frame. The budgets are read from the tickBudgets scope in the
+	// settings, which maps the name of a type (or "Total" for all of them together) to the number of milliseconds it may take per frame.
+	// Timing every tick is not free, so nothing is tracked unless trackTickCosts is set or the window is opened.
+	class TickCostTracker
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		TickCostTracker();
+
+		inline bool IsEnabled() const { return mIsEnabled; }
+		inline void SetEnabled(const bool isEnabled) { mIsEnabled = isEnabled; }
+
+		void AddTick(const std::type_index type, const Clock::duration duration, const AllocationTracker::Counters& allocations);
+
+		// Moves the ticks added since the last call into the history, and warns about the types that went over their budget.
+		void EndFrame();
+
+		static inline bool IsWindowOpen() { return sIsWindowOpen; }
+		static inline void SetWindowOpen(const bool isOpen) { sIsWindowOpen = isOpen; }
+		void DrawImGui() const;
+
+		// Writes the statistics of every type as comma separated values, one type per line.
+		bool Dump(const std::string& filePath) const;
+
+	private:
+		static constexpr uint sNumOfFramesKept = 600;
+		static constexpr float sSecondsBetweenWarnings = 5.0f;
+
+		struct TypeCosts
+		{
+			std::string mName{};
+			std::optional<float> mBudget{};
+
+			Clock::duration mDurationThisFrame{};
+			uint mNumOfTicksThisFrame{};
+			AllocationTracker::Counters mAllocationsThisFrame{};
+
+			// The last sNumOfFramesKept frames, the durations are in milliseconds.
+			std::array<float, sNumOfFramesKept> mFrameDurations{};
+			std::array<uint, sNumOfFramesKept> mFrameNumOfTicks{};
+			std::array<AllocationTracker::Counters, sNumOfFramesKept> mFrameAllocations{};
+			uint64_t mNumOfFramesRecorded{};
+
+			uint64_t mNumOfFramesOverBudget{};
+			uint mNumOfFramesOverBudgetSinceWarning{};
+			std::optional<Clock::time_point> mLastWarning{};
+		};
+
+		// Over the frames that are still in the history.
+		struct Statistics
+		{
+			float mMean{};
+			float mP50{};
+			float mP95{};
+			float mP99{};
+			float mMax{};
+			float mTicksPerFrame{};
+			float mAllocationsPerFrame{};
+			float mBytesAllocatedPerFrame{};
+		};
+
+		TypeCosts CreateTypeCosts(const std::string& name) const;
+		void EndFrame(TypeCosts& costs);
+		static Statistics CalculateStatistics(const TypeCosts& costs);
+
+		// Without the namespace, so that they are the same on every compiler.
+		static std::string GetReadableName(const std::type_index type);
+
+		std::unordered_map<std::type_index, TypeCosts> mCostsPerType{};
+		TypeCosts mTotalCosts{};
+
+		// Entities of the same type are often ticked one after another, this saves looking them up each time.
+		// The elements of an unordered_map never move, so the pointer stays valid.
+		std::optional<std::type_index> mLastType{};
+		TypeCosts* mLastTypeCosts{};
+
+		bool mIsEnabled{};
+
+		std::unordered_map<std::string, float> mBudgets{};
+
+		static inline bool sIsWindowOpen{};
+	};
+}
\ No newline at end of file
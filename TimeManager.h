@@ -7,14 +7,19 @@ namespace Framework
 		Singleton<TimeManager>
 	{
 	public:
-		static inline float GetDeltaTime() { return Inst().mDeltaTime; }
+		static inline float GetDeltaTime() { return Inst().mFixedDeltaTime.value_or(Inst().mDeltaTime); }
 		static inline float GetRawDeltaTime() { return Inst().mRawDeltaTime; }
 		static inline float GetTimeScale() { return Inst().mTimescale; }
-		static inline float GetTotalTimePassed() { return Inst().mTotalTimePassed; }
+		static inline float GetTotalTimePassed() { return Inst().mSimulatedTimePassed.value_or(Inst().mTotalTimePassed); }
 		static inline uint GetCurrentFrame() { return Inst().mCurrentFrame; }
 
 		static inline void SetTimeScale(float scale) { Inst().mTimescale = scale; }
 
+		// Used by deterministic scenes, so that what they simulate does not depend on the framerate or on how long the game has been running.
+		// GetDeltaTime returns the fixed delta time while one is set, GetTotalTimePassed the simulated time.
+		static inline void SetFixedDeltaTime(std::optional<float> fixedDeltaTime) { Inst().mFixedDeltaTime = fixedDeltaTime; }
+		static inline void SetSimulatedTimePassed(std::optional<float> simulatedTimePassed) { Inst().mSimulatedTimePassed = simulatedTimePassed; }
+
 		static inline void UpdateDeltaTime(float rawDeltaTime)
 		{
 			TimeManager& inst = Inst();
@@ -35,6 +40,9 @@ namespace Framework
 		float mRawDeltaTime{};
 		float mTotalTimePassed{};
 
+		std::optional<float> mFixedDeltaTime{};
+		std::optional<float> mSimulatedTimePassed{};
+
 		uint mCurrentFrame{};
 	};
 }
\ No newline at end of file
@@ -18,6 +18,7 @@ Framework::Transform::Transform(Entity* owner) :
 
 Framework::Transform::~Transform()
 {
+	++sHierarchyVersion;
 	SetParent(nullptr);
 
 	// The children deattach themselves from their parent, to prevent modifying the array while iterating over it, make a copy.
@@ -41,6 +42,7 @@ void Framework::Transform::operator=(const Transform& other)
 	mLocalOrientation = other.mLocalOrientation;
 	mLocalPosition = other.mLocalPosition;
 	mLocalScale = other.mLocalScale;
+	MarkDirty();
 }
 
 glm::vec2 Framework::Transform::GetLocalForward2D() const
@@ -52,41 +54,57 @@ glm::vec2 Framework::Transform::GetLocalForward2D() const
 btTransform Framework::Transform::ToBullet() const
 {
 	btTransform t;
-	glm::mat4 worldMat = GetWorldMatrix();
-	t.setFromOpenGLMatrix(&worldMat[0][0]);
+	t.setFromOpenGLMatrix(&GetWorldMatrix()[0][0]);
 	return t; 
 }
 
-void Framework::Transform::getWorldTransform(btTransform& worldTrans) const
+void Framework::Transform::UpdateLocalMatrix() const
 {
-	glm::mat4 worldMatrix = GetWorldMatrix();
-	worldTrans.setFromOpenGLMatrix(&worldMatrix[0][0]);
-}
+	// Scales first, rotates second, translates last. Written out instead of multiplying the three matrices together.
+	const glm::mat3 rotationMatrix = glm::toMat3(mLocalOrientation);
 
-void Framework::Transform::setWorldTransform(const btTransform& worldTrans)
-{
-	SetLocalOrientation(Math::ToGLM(worldTrans.getRotation()));
-	SetLocalPosition(Math::ToGLM(worldTrans.getOrigin()));
+	mLocalMatrix[0] = glm::vec4{ rotationMatrix[0] * mLocalScale.x, 0.0f };
+	mLocalMatrix[1] = glm::vec4{ rotationMatrix[1] * mLocalScale.y, 0.0f };
+	mLocalMatrix[2] = glm::vec4{ rotationMatrix[2] * mLocalScale.z, 0.0f };
+	mLocalMatrix[3] = glm::vec4{ mLocalPosition, 1.0f };
+
+	mIsLocalMatrixDirty = false;
 }
 
-glm::mat4 Framework::Transform::GetLocalMatrix() const
+void Framework::Transform::UpdateWorldMatrix() const
 {
-    // Scales first, rotates second, translates last.
-    glm::mat4 translationMatrix = glm::translate(glm::mat4{ 1.0f }, mLocalPosition);
-    glm::mat4 scaleMatrix = glm::scale(glm::mat4{ 1.0f }, mLocalScale);
-    glm::mat4 rotationMatrix = glm::toMat4(mLocalOrientation);
-    
-    return translationMatrix * rotationMatrix * scaleMatrix;
+	if (!mIsWorldMatrixDirty)
+	{
+		return;
+	}
+
+	if (mParent == nullptr)
+	{
+		mWorldMatrix = GetLocalMatrix();
+		mWorldOrientation = mLocalOrientation;
+	}
+	else
+	{
+		mWorldMatrix = mParent->GetWorldMatrix() * GetLocalMatrix();
+		mWorldOrientation = mParent->GetWorldOrientation() * mLocalOrientation;
+	}
+
+	mIsWorldMatrixDirty = false;
 }
 
-glm::mat4 Framework::Transform::GetWorldMatrix() const
+void Framework::Transform::MarkWorldMatrixDirty()
 {
-	if (mParent == nullptr)
+	if (mIsWorldMatrixDirty)
 	{
-		return GetLocalMatrix();
+		return;
 	}
 
-	return mParent->GetWorldMatrix() * GetLocalMatrix();
+	mIsWorldMatrixDirty = true;
+
+	for (Transform* child : mChildren)
+	{
+		child->MarkWorldMatrixDirty();
+	}
 }
 
 void Framework::Transform::SetLocalForward(const glm::vec3 forward)
@@ -122,16 +140,9 @@ void Framework::Transform::SetParent(Transform* parent)
 	{
 		mParent->AttachChild(this);
 	}
-}
 
-glm::quat Framework::Transform::GetWorldOrientation() const
-{
-	if (mParent == nullptr)
-	{
-		return GetLocalOrientation();
-	}
-
-	return mParent->GetWorldOrientation() * GetLocalOrientation();
+	++sHierarchyVersion;
+	MarkWorldMatrixDirty();
 }
 
 void Framework::Transform::AttachChild(Transform* child)
@@ -301,11 +312,7 @@ void Framework::Transform::Deserialize(const Framework::Data::Scope& parentScope
 	{
 		EntityId tmp;
 		parentOwnerId.value() >> tmp;
-		scene.mEntityManager->DelayedIdRequest(tmp, 
-			[](Entity& entity, void* me)
-			{
-				static_cast<Transform*>(me)->SetParent(&entity.GetTransform());
-			}, this);
+		scene.mEntityManager->ResolveParentOnceLoaded(tmp, *this);
 	}
 
 	LoadFrom(transformScope);
@@ -313,6 +320,8 @@ void Framework::Transform::Deserialize(const Framework::Data::Scope& parentScope
 
 void Framework::Transform::LoadFrom(const Framework::Data::Scope& scope)
 {
+	MarkDirty();
+
 	scope.GetVariable("p") >> mLocalPosition;
 	scope.GetVariable("o") >> mLocalOrientation;
 
@@ -11,8 +11,7 @@ namespace Framework
 	class Entity;
 	class Scene;
 
-	class Transform :
-		public btMotionState
+	class Transform
 	{
 	public:
 		Transform();
@@ -24,11 +23,17 @@ namespace Framework
 		void operator=(const Transform& other);
 
 		btTransform ToBullet() const;
-		void getWorldTransform(btTransform& worldTrans) const override;
-		void setWorldTransform(const btTransform& worldTrans) override;
 
-		glm::mat4 GetLocalMatrix() const;
-		glm::mat4 GetWorldMatrix() const;
+		// Both are cached, and only recalculated after the transform or one of its parents has changed.
+		inline const glm::mat4& GetLocalMatrix() const { if (mIsLocalMatrixDirty) UpdateLocalMatrix(); return mLocalMatrix; }
+		inline const glm::mat4& GetWorldMatrix() const { if (mIsWorldMatrixDirty) UpdateWorldMatrix(); return mWorldMatrix; }
+
+		// Recalculates the world matrix if it is outdated. Does not recurse if the parent's world matrix is already up to date,
+		// which is the case when the hierarchy is updated from parents to children, see EntityManager::UpdateWorldMatrices.
+		void UpdateWorldMatrix() const;
+
+		// Changes whenever any transform is reparented or destroyed.
+		static inline uint64_t GetHierarchyVersion() { return sHierarchyVersion; }
 
 		inline glm::vec3 GetLocalForward() const { return RotateVector(glm::vec3{ 0.0f, 0.0f, 1.0f }, mLocalOrientation); }
 		inline glm::vec3 GetLocalUp() const { return RotateVector(glm::vec3{ 0.0f, 1.0f, 0.0f }, mLocalOrientation); }
@@ -54,7 +59,7 @@ namespace Framework
 		inline bool IsOrphan() const { return mParent == nullptr; }
 
 		inline glm::vec3 GetWorldPosition() const { return GetWorldMatrix() * glm::vec4{0.0f, 0.0f, 0.0f, 1.0f}; }
-		glm::quat GetWorldOrientation() const;
+		inline glm::quat GetWorldOrientation() const { if (mIsWorldMatrixDirty) UpdateWorldMatrix(); return mWorldOrientation; }
 		//inline glm::vec3 GetWorldScale() const { assert(true); }
 
 		inline glm::vec3 GetLocalPosition() const { return mLocalPosition; }
@@ -63,14 +68,14 @@ namespace Framework
 		inline glm::vec3 GetLocalOrienationEuler() const { return glm::eulerAngles(mLocalOrientation); }
 		inline glm::vec3 GetLocalScale() const { return mLocalScale; }
 
-		inline void SetLocalPosition(const glm::vec3 position)	{ mLocalPosition = position; }
-		inline void SetLocalPosition(const glm::vec2 position)	{ mLocalPosition.x = position.x, mLocalPosition.z = position.y; }
+		inline void SetLocalPosition(const glm::vec3 position)	{ mLocalPosition = position; MarkDirty(); }
+		inline void SetLocalPosition(const glm::vec2 position)	{ mLocalPosition.x = position.x, mLocalPosition.z = position.y; MarkDirty(); }
 
 		// In radians
-		inline void SetLocalOrientation(const glm::vec3 rotationEuler) { mLocalOrientation = glm::quat{ rotationEuler }; }
-		inline void SetLocalOrientation(const glm::quat rotation) { mLocalOrientation = rotation; }
+		inline void SetLocalOrientation(const glm::vec3 rotationEuler) { mLocalOrientation = glm::quat{ rotationEuler }; MarkDirty(); }
+		inline void SetLocalOrientation(const glm::quat rotation) { mLocalOrientation = rotation; MarkDirty(); }
 
-		inline void SetLocalScale(const glm::vec3 scale)		{ mLocalScale = scale; }
+		inline void SetLocalScale(const glm::vec3 scale)		{ mLocalScale = scale; MarkDirty(); }
 
 		inline void SetLocalPosition(const float x, const float y, const float z)	{ SetLocalPosition(glm::vec3{ x, y, z }); }
 		inline void SetLocalOrientation(const float x, const float y, const float z)	{ SetLocalOrientation(glm::vec3{ x, y, z }); }
@@ -99,6 +104,12 @@ namespace Framework
 		void AttachChild(Transform* child);
 		void DetachChild(Transform* child);
 
+		inline void MarkDirty() { mIsLocalMatrixDirty = true; MarkWorldMatrixDirty(); }
+		// Marks the children as well, unless this one already was. A transform is never up to date while its parent is outdated.
+		void MarkWorldMatrixDirty();
+
+		void UpdateLocalMatrix() const;
+
 		Entity* const mOwner{};
 
 		Transform* mParent{};
@@ -107,5 +118,13 @@ namespace Framework
 		glm::vec3 mLocalPosition{};
 		glm::quat mLocalOrientation = { 1.0f, 0.0f, 0.0f, 0.0f };
 		glm::vec3 mLocalScale = { 1.0f, 1.0f, 1.0f };
+
+		mutable glm::mat4 mLocalMatrix{ 1.0f };
+		mutable glm::mat4 mWorldMatrix{ 1.0f };
+		mutable glm::quat mWorldOrientation = { 1.0f, 0.0f, 0.0f, 0.0f };
+		mutable bool mIsLocalMatrixDirty = true;
+		mutable bool mIsWorldMatrixDirty = true;
+
+		static inline uint64_t sHierarchyVersion{};
 	};
 }
\ No newline at end of file
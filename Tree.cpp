@@ -23,7 +23,7 @@ RTS::Tree::Tree(Framework::Scene& scene, const glm::vec2 position) :
 
 	static btCylinderShape* shape = new btCylinderShape({ 0.5f, 3.0f, 0.5f});
 	
-	mCollisionObject = std::make_unique<btCollisionObject>();
+	mCollisionObject = mCollisionObjectStorage.Construct();
 	mCollisionObject->setCollisionShape(shape);
 	myTransform.TranslateLocalPosition(myTransform.GetLocalUp() * 0.5f * 0.5f);
 	mCollisionObject->setWorldTransform(myTransform.ToBullet());
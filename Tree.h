@@ -19,5 +19,7 @@ namespace RTS
         static constexpr float sMaxScale = 1.0f;
 
         static constexpr float sMaxRotationXZ = TWOPI * (7.0f / 360.0f);
+
+        Framework::CollisionObjectStorage<btCollisionObject> mCollisionObjectStorage{};
     };
 }
\ No newline at end of file
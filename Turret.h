@@ -18,6 +18,7 @@ namespace RTS
 		void FixedTick() override;
 
 		bool Serialize(Framework::Data::Scope& parentScope) const;
+		inline bool HasStateBesidesTransform() const { return true; }
 
 		void Deserialize(const Framework::Data::Scope& parentScope);
 
@@ -11,6 +11,7 @@
 #include "ProceduralUnitFactory.h"
 #include "AssetManager.h"
 #include "Explosion.h"
+#include "Profiler.h"
 
 RTS::Unit::Unit(Framework::Scene& scene, Army* army) :
 	Agent(scene)
@@ -53,7 +54,11 @@ void RTS::Unit::SetUnitBodyData(const UnitBodyData* data, const std::optional<Ar
 		&& "There's already a collisionobject, don't make a new one without cleaning up nicely first");
 
 
-	mCollisionObject = std::make_unique<btRigidBody>(data->mMass, &GetTransform(), data->mShape.get(), data->mInertia);
+	// Without a motion state, the physics copies the transforms of all moving bodies at once after stepping.
+	btRigidBody::btRigidBodyConstructionInfo constructionInfo{ data->mMass, nullptr, data->mShape.get(), data->mInertia };
+	constructionInfo.m_startWorldTransform = GetTransform().ToBullet();
+
+	mCollisionObject = mRigidBodyStorage.Construct(constructionInfo);
 	mCollisionObject->setUserPointer(this);
 
 	mScene.mPhysics->AddCollisionObjectToWorld(mCollisionObject.get(), Framework::Physics::Group::unitGroup, Framework::Physics::Mask::unitMask);
@@ -86,7 +91,9 @@ Framework::Agent::AgentInput RTS::Unit::CalculateDesiredVelocity()
 
 std::optional<RTS::Unit*> RTS::Unit::CheckForUnitToAttack()
 {
-	std::vector<RTS::Unit*> nearbyUnits = GetUnitsInSight();
+	PROFILE_ZONE("Unit::CheckForUnitToAttack");
+
+	const Framework::FrameVector<RTS::Unit*> nearbyUnits = GetUnitsInSight();
 
 	const ArmyId myArmyId = GetArmyId();
 	const glm::vec2 myPosition2D = GetTransform().GetLocalPosition2D();
@@ -118,7 +125,7 @@ std::optional<RTS::Unit*> RTS::Unit::CheckForUnitToAttack()
 	return std::optional<RTS::Unit*>();
 }
 
-std::vector<RTS::Unit*> RTS::Unit::GetUnitsInSight()
+Framework::FrameVector<RTS::Unit*> RTS::Unit::GetUnitsInSight()
 {
 	mScene.mPhysics->Query(mSightInquirer, GetTransform());
 
@@ -127,7 +134,7 @@ std::vector<RTS::Unit*> RTS::Unit::GetUnitsInSight()
 		return {};
 	}
 
-	std::vector<RTS::Unit*> units;
+	Framework::FrameVector<RTS::Unit*> units;
 	// We will always atleast collide with ourselves
 	units.reserve(mSightInquirer.mCollidedWith.size() - 1);
 
@@ -267,9 +274,5 @@ void RTS::Unit::Deserialize(const Framework::Data::Scope& parentScope)
 	Framework::EntityId armyEntityId;
 	myScope.GetVariable("armyEntityId") >> armyEntityId;
 
-	mScene.mEntityManager->DelayedIdRequest(armyEntityId,
-		[](Entity& entity, void* me)
-		{
-			static_cast<Unit*>(me)->SetArmy(dynamic_cast<Army*>(&entity));
-		}, this);
+	mScene.mEntityManager->ResolveOnceLoaded(armyEntityId, mArmy);
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include "Agent.h"
 #include "Commands.h"
+#include "FrameArena.h"
 
 namespace RTS
 {
@@ -38,7 +39,8 @@ namespace RTS
 		void Deserialize(const Framework::Data::Scope& parentScope) override;
 
 		std::optional<Unit*> CheckForUnitToAttack();
-		std::vector<Unit*> GetUnitsInSight();
+		// Allocated from the frame arena.
+		Framework::FrameVector<Unit*> GetUnitsInSight();
 
 		template<typename CommandType, typename ...Args>
 		bool AttemptTransition(bool condition, Args && ...args)
@@ -62,6 +64,7 @@ namespace RTS
 		const UnitBodyData* mUnitBodyData{};
 
 		Framework::Inquirer mSightInquirer{};
+		Framework::CollisionObjectStorage<btRigidBody> mRigidBodyStorage{};
 
 		float mHealth = 1.0f;
 		bool mSwitchedState{};
@@ -1,9 +1,73 @@
 #include "precomp.h"
 #include "Variable.h"
 
-Framework::Data::Variable::Variable(const std::string& name, const std::string& value, const Format format) :
+Framework::Data::Variable::Variable(const std::string& name, std::string_view value, const Format format) :
 	mName(name),
-	mValue(value),
 	mFormat(format)
 {
+	SetValue(value);
 }
+
+Framework::Data::Variable::Variable(const InternedString name, std::string_view value, const Format format) :
+	mName(name),
+	mFormat(format)
+{
+	SetValue(value);
+}
+
+std::string_view Framework::Data::Variable::GetValue() const
+{
+	if (const InlineValue* inlineValue = std::get_if<InlineValue>(&mValue))
+	{
+		return { inlineValue->mData.data(), inlineValue->mSize };
+	}
+
+	return std::get<std::string>(mValue);
+}
+
+void Framework::Data::Variable::SetValue(std::string_view value)
+{
+	// Resizing may destroy or reallocate the current value before the new one is written, so a value that points into it is copied first.
+	const std::string_view current = GetValue();
+	const std::less<const char*> isBefore{};
+
+	if (!value.empty()
+		&& !isBefore(value.data(), current.data())
+		&& isBefore(value.data(), current.data() + current.size()))
+	{
+		const std::string copy{ value };
+		SetValue(copy);
+		return;
+	}
+
+	char* destination = ResizeValue(value.size());
+
+	if (!value.empty())
+	{
+		memcpy(destination, value.data(), value.size());
+	}
+}
+
+char* Framework::Data::Variable::ResizeValue(const size_t size)
+{
+	if (size <= sInlineCapacity)
+	{
+		InlineValue* inlineValue = std::get_if<InlineValue>(&mValue);
+		if (inlineValue == nullptr)
+		{
+			inlineValue = &mValue.emplace<InlineValue>();
+		}
+
+		inlineValue->mSize = static_cast<uint8_t>(size);
+		return inlineValue->mData.data();
+	}
+
+	std::string* value = std::get_if<std::string>(&mValue);
+	if (value == nullptr)
+	{
+		value = &mValue.emplace<std::string>();
+	}
+
+	value->resize(size);
+	return value->data();
+}
\ No newline at end of file
@@ -1,4 +1,8 @@
 #pragma once
+#include "InternedString.h"
+
+#include <charconv>
+#include <variant>
 
 namespace Framework::Data
 {
@@ -11,28 +15,32 @@ namespace Framework::Data
 	{
 	public:
 		Variable() = default;
-		Variable(const std::string& name, const std::string& value, const Format format);
+		Variable(const std::string& name, std::string_view value, const Format format);
+		Variable(const InternedString name, std::string_view value, const Format format);
 
-		inline const std::string& GetName() const { return mName; }
-		inline const std::string& GetValue() const { return mValue; }
+		inline const std::string& GetName() const { return mName.GetString(); }
+		inline InternedString GetInternedName() const { return mName; }
+		std::string_view GetValue() const;
 
-		bool operator==(const Variable& other) const { return mValue == other.mValue; }
-		bool operator!=(const Variable& other) const { return mValue != other.mValue; }
+		bool operator==(const Variable& other) const { return GetValue() == other.GetValue(); }
+		bool operator!=(const Variable& other) const { return GetValue() != other.GetValue(); }
 
 		// Basic types
 		template<typename T>
 		inline void operator<<(const T& value)
 		{
-			if (mFormat == Format::readable)
+			if constexpr (std::is_convertible_v<const T&, std::string_view>)
 			{
-				// Borrow stringstream write operations
-				std::stringstream tmpStream{};
-				tmpStream << value;
-				mValue = tmpStream.str();
+				SetValue(std::string_view{ value });
+			}
+			else if (mFormat == Format::readable)
+			{
+				char buffer[sMaxTextSize];
+				SetValue({ buffer, static_cast<size_t>(WriteAsText(buffer, buffer + sMaxTextSize, value) - buffer) });
 			}
 			else
 			{
-				mValue = ConvertToBinary(value);
+				SetAsBinary(value);
 			}
 		}
 
@@ -41,23 +49,23 @@ namespace Framework::Data
 		{
 			if (mFormat == Format::readable)
 			{
-				std::stringstream tmpStream = std::stringstream{ mValue };
-				tmpStream >> value;
+				std::string_view text = GetValue();
+				ReadAsText(text, value);
 			}
 			else
 			{
-				ConvertFromBinary(mValue, value);
+				GetAsBinary(value);
 			}
 		}
 
 		inline void operator>>(std::string& value) const
 		{
-			value = mValue;
+			value = GetValue();
 		}
 
 		inline void operator<<(const std::string& value)
 		{
-			mValue = value;
+			SetValue(value);
 		}
 
 		inline void operator<<(const bool& value)
@@ -66,11 +74,11 @@ namespace Framework::Data
 			{
 				if (value)
 				{
-					mValue = "true";
+					SetValue("true");
 				}
 				else
 				{
-					mValue = "false";
+					SetValue("false");
 				}
 			}
 			else
@@ -83,12 +91,12 @@ namespace Framework::Data
 		{
 			if (mFormat == Format::readable)
 			{
-				if (mValue == "true")
+				if (GetValue() == "true")
 				{
 					value = true;
 					return;
 				}
-				else if (mValue == "false")
+				else if (GetValue() == "false")
 				{
 					value = false;
 					return;
@@ -104,40 +112,152 @@ namespace Framework::Data
 			return mFormat; 
 		}
 
+		void SetValue(std::string_view value);
+
+		// Makes the value the given size and returns where to write it, so it can be filled in without a temporary.
+		char* ResizeValue(const size_t size);
+
+		// The bytes of the value as they are in memory.
+		template<typename T>
+		void SetAsBinary(const T& value);
+
+		template<typename T>
+		void GetAsBinary(T& out) const;
+
+		// Writes the value as text, returns the end of what was written. Numbers are formatted without going through a
+		// stream, which means they're independent of the locale and floats are written in the shortest form that reads back exactly.
 		template<typename T>
-		static std::string ConvertToBinary(const T& value);
-		
+		static char* WriteAsText(char* begin, char* end, const T& value);
+
+		// Reads the value from the start of the text, the text is moved past whatever was read.
 		template<typename T>
-		static void ConvertFromBinary(const std::string& binaryStr, T& out);
+		static void ReadAsText(std::string_view& text, T& out);
+
+		// Enough for any number, or a short piece of text.
+		static constexpr size_t sMaxTextSize = 64;
 
 	private:
-		std::string mName{};
+		// Most values are a number, a vector or an id. Those are stored inline, so that variables do not need
+		// to allocate. The size is chosen so that the whole value takes up 48 bytes.
+		static constexpr size_t sInlineCapacity = 38;
+
+		struct InlineValue
+		{
+			std::array<char, sInlineCapacity> mData;
+			uint8_t mSize;
+		};
+
+		InternedString mName{};
 		// The value stored on file for this variable will be set to this value at the time of saving.
-		std::string mValue{};
+		std::variant<InlineValue, std::string> mValue{};
 
 		Format mFormat{};
 	};
 
 	template<typename T>
-	inline std::string Variable::ConvertToBinary(const T& value)
+	inline void Variable::SetAsBinary(const T& value)
 	{
 		static_assert(std::is_trivially_copyable<T>::value);
 
-		constexpr size_t size = sizeof(T);
-		const char* data = reinterpret_cast<const char*>(&value);
+		memcpy(ResizeValue(sizeof(T)), &value, sizeof(T));
+	}
+
+	template<typename T>
+	inline void Variable::GetAsBinary(T& out) const
+	{
+		static_assert(std::is_trivially_copyable<T>::value);
 
-		return std::string{ data, size };
+		const std::string_view value = GetValue();
+		assert(value.size() >= sizeof(T));
+
+		memcpy(&out, value.data(), std::min(value.size(), sizeof(T)));
 	}
 
+	template<typename T>
+	inline char* Variable::WriteAsText(char* begin, char* end, const T& value)
+	{
+		if constexpr (std::is_same_v<T, char>
+			|| std::is_same_v<T, signed char>
+			|| std::is_same_v<T, unsigned char>)
+		{
+			// Characters have always been stored as they are, not as a number.
+			if (begin != end)
+			{
+				*begin++ = static_cast<char>(value);
+			}
+			return begin;
+		}
+		else if constexpr (std::is_enum_v<T>)
+		{
+			return WriteAsText(begin, end, static_cast<std::underlying_type_t<T>>(value));
+		}
+		else if constexpr (std::is_arithmetic_v<T>)
+		{
+			return std::to_chars(begin, end, value).ptr;
+		}
+		else
+		{
+			// Anything else still relies on its stream operator.
+			std::stringstream tmpStream{};
+			tmpStream << value;
+			const std::string text = tmpStream.str();
+
+			const size_t size = std::min(text.size(), static_cast<size_t>(end - begin));
+			memcpy(begin, text.data(), size);
+			return begin + size;
+		}
+	}
 
 	template<typename T>
-	inline void Variable::ConvertFromBinary(const std::string& binaryStr, T& out)
+	inline void Variable::ReadAsText(std::string_view& text, T& out)
 	{
-		static_assert(std::is_trivially_copyable<T>::value);
+		// Streams skip leading whitespace as well.
+		while (!text.empty()
+			&& std::isspace(static_cast<unsigned char>(text.front())))
+		{
+			text.remove_prefix(1);
+		}
+
+		if constexpr (std::is_same_v<T, char>
+			|| std::is_same_v<T, signed char>
+			|| std::is_same_v<T, unsigned char>)
+		{
+			if (!text.empty())
+			{
+				out = static_cast<T>(text.front());
+				text.remove_prefix(1);
+			}
+		}
+		else if constexpr (std::is_enum_v<T>)
+		{
+			std::underlying_type_t<T> tmp{};
+			ReadAsText(text, tmp);
+			out = static_cast<T>(tmp);
+		}
+		else if constexpr (std::is_arithmetic_v<T>)
+		{
+			if (!text.empty()
+				&& text.front() == '+')
+			{
+				text.remove_prefix(1);
+			}
+
+			const std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), out);
+
+			if (result.ec != std::errc{})
+			{
+				// Same as a stream that failed to read.
+				out = T{};
+			}
 
-		constexpr size_t numOfBytes = sizeof(T);
-		char* dest = reinterpret_cast<char*>(&out);
-		memcpy(dest, binaryStr.c_str(), numOfBytes);
+			text.remove_prefix(static_cast<size_t>(result.ptr - text.data()));
+		}
+		else
+		{
+			std::stringstream tmpStream = std::stringstream{ std::string{ text } };
+			tmpStream >> out;
+			text = {};
+		}
 	}
 }
 
@@ -147,18 +267,30 @@ void operator<<(Framework::Data::Variable& destination, const std::vector<T>& va
 	const char* binaryData = reinterpret_cast<const char*>(value.data());
 	const size_t numOfBytes = value.size() * sizeof(T);
 
-	const std::string binaryString = { binaryData, numOfBytes };
-
 	switch (destination.GetFormat())
 	{
 	case Framework::Data::Format::readable:
 	{
-		destination << Framework::StringFunctions::BinaryToHex(binaryString);
+		static constexpr char syms[] = "0123456789ABCDEF";
+		char* hex = destination.ResizeValue(numOfBytes * 2);
+
+		for (size_t i = 0; i < numOfBytes; i++)
+		{
+			hex[i * 2] = syms[(binaryData[i] >> 4) & 0xf];
+			hex[i * 2 + 1] = syms[binaryData[i] & 0xf];
+		}
 		break;
 	}
 	case Framework::Data::Format::binary:
 	{
-		destination << binaryString;
+		if (numOfBytes != 0)
+		{
+			memcpy(destination.ResizeValue(numOfBytes), binaryData, numOfBytes);
+		}
+		else
+		{
+			destination.ResizeValue(0);
+		}
 		break;
 	}
 	}
@@ -167,25 +299,52 @@ void operator<<(Framework::Data::Variable& destination, const std::vector<T>& va
 template<typename T>
 void operator>>(const Framework::Data::Variable& source, std::vector<T>& out)
 {
-	std::string binaryString = source.GetValue();
+	const std::string_view sourceValue = source.GetValue();
 
 	switch (source.GetFormat())
 	{
 	case Framework::Data::Format::readable:
 	{
-		binaryString = Framework::StringFunctions::HexToBinary(binaryString);
+		const auto nibble = [](const char ch) -> char
+			{
+				if (ch >= '0' && ch <= '9')
+				{
+					return static_cast<char>(ch - '0');
+				}
+				if (ch >= 'A' && ch <= 'F')
+				{
+					return static_cast<char>(ch - 'A' + 10);
+				}
+				if (ch >= 'a' && ch <= 'f')
+				{
+					return static_cast<char>(ch - 'a' + 10);
+				}
+				return 0;
+			};
+
+		const size_t numOfBytes = (sourceValue.size() + 1) / 2;
+		out.resize(numOfBytes / sizeof(T));
+		char* binaryData = reinterpret_cast<char*>(out.data());
+
+		for (size_t i = 0; i < out.size() * sizeof(T); i++)
+		{
+			const char high = nibble(sourceValue[i * 2]);
+			const char low = i * 2 + 1 < sourceValue.size() ? nibble(sourceValue[i * 2 + 1]) : 0;
+			binaryData[i] = static_cast<char>((high << 4) + low);
+		}
 		break;
 	}
 	case Framework::Data::Format::binary:
 	{
-		// Already in binary format
+		out.resize(sourceValue.size() / sizeof(T));
+
+		if (!out.empty())
+		{
+			memcpy(out.data(), sourceValue.data(), out.size() * sizeof(T));
+		}
 		break;
 	}
 	}
-
-	const size_t vectorSize = binaryString.size() / sizeof(T);
-	out.resize(vectorSize);
-	memcpy(out.data(), binaryString.c_str(), binaryString.size());
 }
 
 template<glm::length_t N, typename T>
@@ -195,22 +354,26 @@ void operator<<(Framework::Data::Variable& destination, const glm::vec<N, T>& va
 	{
 	case Framework::Data::Format::readable:
 	{
-		std::string tmpString{};
+		char buffer[N * Framework::Data::Variable::sMaxTextSize];
+		char* const end = buffer + sizeof(buffer);
+		char* current = buffer;
+
 		for (glm::length_t i = 0; i < N; i++)
 		{
-			tmpString.append(std::to_string(value[i]));
+			current = Framework::Data::Variable::WriteAsText(current, end, value[i]);
 
 			if (i != N - 1)
 			{
-				tmpString.append(", ");
+				*current++ = ',';
+				*current++ = ' ';
 			}
 		}
-		destination << tmpString;
+		destination.SetValue({ buffer, static_cast<size_t>(current - buffer) });
 		break;
 	}
 	case Framework::Data::Format::binary:
 	{
-		destination << Framework::Data::Variable::ConvertToBinary(value);
+		destination.SetAsBinary(value);
 		break;
 	}
 	}
@@ -219,29 +382,28 @@ void operator<<(Framework::Data::Variable& destination, const glm::vec<N, T>& va
 template<glm::length_t N, typename T>
 void operator>>(const Framework::Data::Variable& source, glm::vec<N, T>& out)
 {
-	const std::string& sourceValue = source.GetValue();
 	switch (source.GetFormat())
 	{
 	case Framework::Data::Format::readable:
 	{
-		std::stringstream stringStream = std::stringstream{ sourceValue };
+		std::string_view text = source.GetValue();
 
 		for (glm::length_t i = 0; i < N; i++)
 		{
-			stringStream >> out[i];
+			Framework::Data::Variable::ReadAsText(text, out[i]);
 
-			const char nextChar = static_cast<char>(stringStream.peek());
-			if (nextChar == ',')
+			if (!text.empty()
+				&& text.front() == ',')
 			{
-				// Ignore two characters, since theyre seperated by both a comma and a space
-				stringStream.ignore(2);
+				// Seperated by both a comma and a space, the space is skipped when reading the next one.
+				text.remove_prefix(1);
 			}
 		}
 		break;
 	}
 	case Framework::Data::Format::binary:
 	{
-		Framework::Data::Variable::ConvertFromBinary(sourceValue, out);
+		source.GetAsBinary(out);
 		break;
 	}
 	}
@@ -4,6 +4,9 @@ layout(location = 0) in mediump vec3 vertexPosition;
 layout(location = 1) in mediump vec3 vertexNormal;
 layout(location = 2) in mediump vec2 vertexUV;
 
+// Only used when sampling the heightmap, the centre of the chunk that this patch is drawn for.
+layout(location = 3) in highp vec2 patchPosition;
+
 out mediump vec2 fragUV;
 out mediump vec3 fragNormal;
 out highp vec3 fragPos;
@@ -11,12 +14,31 @@ out highp vec3 fragPos;
 uniform mat4 MVP;
 uniform mat4 modelMatrix;
 
+// When true, the vertices are a flat patch that is displaced using the heightmap, instead of a mesh generated for each chunk.
+uniform bool sampleHeightMap;
+uniform highp sampler2D heightSampler;
+uniform highp sampler2D normalSampler;
+uniform highp float spaceBetweenVertices;
+
 void main()
 {
-	gl_Position = MVP * vec4(vertexPosition, 1.0);
-	
+	highp vec3 position = vertexPosition;
+	mediump vec3 normal = vertexNormal;
+
+	if (sampleHeightMap)
+	{
+		position.xz += patchPosition;
+
+		// Every vertex lines up exactly with a sample in the heightmap.
+		ivec2 sampleCoord = ivec2(round(position.xz / spaceBetweenVertices));
+		position.y = texelFetch(heightSampler, sampleCoord, 0).r;
+		normal = texelFetch(normalSampler, sampleCoord, 0).xyz;
+	}
+
+	gl_Position = MVP * vec4(position, 1.0);
+
 	// The terrain has not been rotated or scaled, just pass the normal without adjusting for the model matrix.
-	fragNormal = vertexNormal;
+	fragNormal = normal;
 	fragUV = vertexUV;
-	fragPos = vec3(modelMatrix * vec4(vertexPosition, 1.0));
+	fragPos = vec3(modelMatrix * vec4(position, 1.0));
 }
@@ -11,6 +11,8 @@
 #include "SavedData.h"
 #include "EntityManager.h"
 #include "Settings.h"
+#include "Profiler.h"
+#include "FrameArena.h"
 
 // For building the framework's factories
 #include "Entity.h"
@@ -51,6 +53,7 @@ Framework::Game::~Game() = default;
 void Framework::Game::Init()
 {
 	Settings::Inst().mOnSettingsChanged.bind(this, &Game::OnSettingsChange);
+	Profiler::Inst().SetThreadName("Main");
 
 	// Just to keep everything always loaded into memory.
 	mSandboxData = std::make_unique<Data::SavedData>("sandbox.txt");
@@ -93,6 +96,13 @@ void Framework::Game::EarlyTick()
 // -----------------------------------------------------------
 bool Framework::Game::Tick( float deltaTime)
 {
+	Profiler::Inst().BeginFrame();
+	AllocationTracker::BeginFrame();
+	PROFILE_ZONE("Game::Tick");
+
+	// Once per frame, whether or not a scene is being ticked, so that the arena also stays small while paused or loading.
+	FrameArena::Inst().Reset();
+
 	Framework::TimeManager::UpdateDeltaTime(deltaTime);
 
 	if (mSceneLoader.HasARequestBeenMade())
@@ -115,6 +125,8 @@ bool Framework::Game::Tick( float deltaTime)
 			activeScene.value()->Draw();
 		}
 	}
+
+	Profiler::Inst().DrawImGui();
  
 	return mIsRunning;
 }